@@ -0,0 +1,446 @@
+#include "IniCorpus.h"
+
+#include "IniParser/Ini.h"
+#include "IniParser/IniCompiled.h"
+#include "IniParser/IniEventHandler.h"
+#include "IniParser/IniParser.h"
+#include "IniParser/IniScanner.h"
+#include "IniParser/IniWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Throughput of the library's stages on synthetic corpora:
+//     ini-parser-bench [--size MB] [--seed N] [--repetitions N] [--corpus NAME] [--csv]
+// Every benchmark runs once to warm up, then reports the best of its repetitions.
+// Byte throughput is measured against the source (or, for the writer, the output) size,
+// operation throughput counts lookups or conversions.
+
+namespace inip::bench
+{
+	namespace
+	{
+		struct Options
+		{
+			std::size_t corpusSize{ 16 * 1024 * 1024 };
+			std::uint64_t seed{ 1 };
+			int repetitions{ 5 };
+			std::string corpus;
+			bool csv{ false };
+		};
+
+		struct Measurement
+		{
+			std::string_view benchmark;
+			double seconds{ 0.0 };
+			std::size_t bytes{ 0 };
+			std::size_t operations{ 0 };
+		};
+
+		// Results flow in here, so the compiler can't drop the measured work
+		volatile std::uint64_t sink{ 0 };
+
+		template <typename Function>
+		double BestTime(int repetitions, Function&& function)
+		{
+			function();
+
+			double best = std::numeric_limits<double>::max();
+			for (int repetition = 0; repetition < repetitions; repetition++)
+			{
+				auto begin = std::chrono::steady_clock::now();
+				function();
+				auto end = std::chrono::steady_clock::now();
+				best = std::min(best, std::chrono::duration<double>(end - begin).count());
+			}
+			return best;
+		}
+
+		// Discards everything, the writer is measured rather than the file system
+		class NullBuffer : public std::streambuf
+		{
+		public:
+
+			std::size_t GetWritten() const
+			{
+				return written;
+			}
+
+		protected:
+
+			std::streamsize xsputn(const char* /*data*/, std::streamsize size) override
+			{
+				written += static_cast<std::size_t>(size);
+				return size;
+			}
+			int_type overflow(int_type c) override
+			{
+				written++;
+				return traits_type::not_eof(c);
+			}
+
+		private:
+
+			std::size_t written{ 0 };
+		};
+
+		class CountingHandler : public IniEventHandler
+		{
+		public:
+
+			bool OnGroupBegin(std::string_view /*groupName*/, int /*line*/) override
+			{
+				events++;
+				return true;
+			}
+			bool OnOption(std::string_view /*key*/, std::string_view value, IniOptionType /*optionType*/, int /*line*/) override
+			{
+				events += value.size();
+				return true;
+			}
+
+			std::uint64_t events{ 0 };
+		};
+
+		struct LookupKey
+		{
+			std::string group;
+			std::string key;
+		};
+
+		// Random existing options, the same ones for every lookup benchmark
+		std::vector<LookupKey> SampleKeys(const IniSettings& iniSettings, std::size_t count, std::uint64_t seed)
+		{
+			std::vector<LookupKey> all;
+			iniSettings.ForEachGroup([&](const IniGroup& iniGroup)
+			{
+				iniGroup.ForEachOption([&](const IniOption& iniOption)
+				{
+					all.push_back(LookupKey{ std::string{ iniGroup.GetGroupName() }, std::string{ iniOption.GetKey() } });
+				});
+			});
+			if (all.empty())
+				return all;
+
+			std::mt19937_64 engine{ seed };
+			std::vector<LookupKey> sample;
+			sample.reserve(count);
+			for (std::size_t key = 0; key < count; key++)
+				sample.push_back(all[engine() % all.size()]);
+			return sample;
+		}
+
+		std::shared_ptr<IniSettings> ParseSettings(std::string_view source, IniParseMode parseMode)
+		{
+			IniParser iniParser;
+			iniParser.SetParseMode(parseMode);
+			iniParser.Parse(source, "bench");
+			return iniParser.GetIniSettings();
+		}
+
+		std::vector<Measurement> RunCorpus(std::string_view source, const Options& options)
+		{
+			std::vector<Measurement> measurements;
+			int repetitions = options.repetitions;
+
+			// Scanner
+
+			{
+				IniScanner iniScanner;
+				double seconds = BestTime(repetitions, [&]()
+				{
+					iniScanner.Clear();
+					iniScanner.Scan(source);
+					sink = sink + iniScanner.GetTokensPtr()->size();
+				});
+				measurements.push_back(Measurement{ "scan", seconds, source.size(), 0 });
+			}
+			{
+				IniScanner iniScanner;
+				double seconds = BestTime(repetitions, [&]()
+				{
+					iniScanner.Begin(source);
+					std::uint64_t tokens{ 0 };
+					while (iniScanner.NextToken().type != TokenType::END_OF_FILE)
+						tokens++;
+					sink = sink + tokens;
+				});
+				measurements.push_back(Measurement{ "scan/streaming", seconds, source.size(), 0 });
+			}
+
+			// Parser
+
+			const std::pair<std::string_view, IniParseMode> parseModes[]
+			{
+				{ "parse/two-phase", IniParseMode::TWO_PHASE },
+				{ "parse/streaming", IniParseMode::STREAMING },
+				{ "parse/parallel", IniParseMode::PARALLEL },
+			};
+			for (const auto& [benchmark, parseMode] : parseModes)
+			{
+				double seconds = BestTime(repetitions, [&]()
+				{
+					sink = sink + ParseSettings(source, parseMode)->GetSettingsGroups().size();
+				});
+				measurements.push_back(Measurement{ benchmark, seconds, source.size(), 0 });
+			}
+			{
+				// Only the pre-pass, no group is looked up
+				double seconds = BestTime(repetitions, [&]()
+				{
+					sink = sink + ParseSettings(source, IniParseMode::LAZY).use_count();
+				});
+				measurements.push_back(Measurement{ "parse/lazy", seconds, source.size(), 0 });
+			}
+			{
+				// Through the default 64 KB buffer
+				double seconds = BestTime(repetitions, [&]()
+				{
+					std::istringstream iniStream{ std::string{ source } };
+					IniParser iniParser;
+					iniParser.ParseStream(iniStream, "bench");
+					sink = sink + iniParser.GetIniSettings()->GetSettingsGroups().size();
+				});
+				measurements.push_back(Measurement{ "parse/stream", seconds, source.size(), 0 });
+			}
+			{
+				IniParser iniParser;
+				double seconds = BestTime(repetitions, [&]()
+				{
+					CountingHandler handler;
+					iniParser.ParseEvents(source, handler);
+					sink = sink + handler.events;
+				});
+				measurements.push_back(Measurement{ "parse/events", seconds, source.size(), 0 });
+			}
+
+			std::shared_ptr<IniSettings> iniSettings = ParseSettings(source, IniParseMode::STREAMING);
+
+			// Lookups
+
+			constexpr std::size_t lookupsCount{ 1000 * 1000 };
+			std::vector<LookupKey> lookupKeys = SampleKeys(*iniSettings, lookupsCount, options.seed);
+			if (!lookupKeys.empty())
+			{
+				double seconds = BestTime(repetitions, [&]()
+				{
+					std::uint64_t found{ 0 };
+					for (const LookupKey& lookupKey : lookupKeys)
+					{
+						const IniGroup* iniGroup = iniSettings->FindGroup(lookupKey.group);
+						found += iniGroup && iniGroup->FindOption(lookupKey.key);
+					}
+					sink = sink + found;
+				});
+				measurements.push_back(Measurement{ "lookup", seconds, 0, lookupKeys.size() });
+
+				// Same keys with their hashes computed up front
+				std::vector<std::pair<IniKey, IniKey>> hashedKeys;
+				hashedKeys.reserve(lookupKeys.size());
+				for (const LookupKey& lookupKey : lookupKeys)
+					hashedKeys.emplace_back(IniKey{ lookupKey.group }, IniKey{ lookupKey.key });
+
+				seconds = BestTime(repetitions, [&]()
+				{
+					std::uint64_t found{ 0 };
+					for (const auto& [groupKey, optionKey] : hashedKeys)
+					{
+						const IniGroup* iniGroup = iniSettings->FindGroup(groupKey);
+						found += iniGroup && iniGroup->FindOption(optionKey);
+					}
+					sink = sink + found;
+				});
+				measurements.push_back(Measurement{ "lookup/prehashed", seconds, 0, hashedKeys.size() });
+
+				// Same keys resolved into handles, the warm-up run resolves them
+				std::vector<IniOptionHandle> handles;
+				handles.reserve(hashedKeys.size());
+				for (const auto& [groupKey, optionKey] : hashedKeys)
+					handles.emplace_back(groupKey, optionKey);
+
+				seconds = BestTime(repetitions, [&]()
+				{
+					std::uint64_t found{ 0 };
+					for (IniOptionHandle& handle : handles)
+						found += handle.Find(*iniSettings) != nullptr;
+					sink = sink + found;
+				});
+				measurements.push_back(Measurement{ "lookup/handle", seconds, 0, handles.size() });
+
+				IniCompiledSettings compiledSettings;
+				std::string compiled = CompileSettings(*iniSettings);
+				compiledSettings.OpenBuffer(compiled);
+				seconds = BestTime(repetitions, [&]()
+				{
+					std::uint64_t found{ 0 };
+					for (const auto& [groupKey, optionKey] : hashedKeys)
+					{
+						IniCompiledGroup iniGroup = compiledSettings.FindGroup(groupKey);
+						found += iniGroup && iniGroup.FindOption(optionKey);
+					}
+					sink = sink + found;
+				});
+				measurements.push_back(Measurement{ "lookup/compiled", seconds, 0, hashedKeys.size() });
+			}
+
+			// Typed conversions
+
+			std::vector<const IniOption*> iniOptions;
+			iniSettings->ForEachGroup([&](const IniGroup& iniGroup)
+			{
+				iniGroup.ForEachOption([&](const IniOption& iniOption)
+				{
+					iniOptions.push_back(&iniOption);
+				});
+			});
+			if (!iniOptions.empty())
+			{
+				double seconds = BestTime(repetitions, [&]()
+				{
+					double sum{ 0.0 };
+					for (const IniOption* iniOption : iniOptions)
+					{
+						if (iniOption->GetOptionType() == IniOptionType::INTEGER)
+							sum += static_cast<double>(iniOption->TryGetValue<long long>().GetValueOr(0));
+						else if (iniOption->GetOptionType() == IniOptionType::FLOAT)
+							sum += iniOption->TryGetValue<double>().GetValueOr(0.0);
+						else
+							sum += static_cast<double>(iniOption->TryGetValue<std::string_view>().GetValue().size());
+					}
+					sink = sink + static_cast<std::uint64_t>(sum);
+				});
+				measurements.push_back(Measurement{ "convert", seconds, 0, iniOptions.size() });
+
+				// Every value read as text and converted on the spot
+				seconds = BestTime(repetitions, [&]()
+				{
+					std::uint64_t converted{ 0 };
+					for (const IniOption* iniOption : iniOptions)
+					{
+						std::string_view text = iniOption->TryGetValue<std::string_view>().GetValue();
+						double value{ 0.0 };
+						auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+						converted += ec == std::errc{};
+					}
+					sink = sink + converted;
+				});
+				measurements.push_back(Measurement{ "convert/from-text", seconds, 0, iniOptions.size() });
+			}
+
+			// Writer
+
+			{
+				std::size_t written{ 0 };
+				double seconds = BestTime(repetitions, [&]()
+				{
+					NullBuffer nullBuffer;
+					std::ostream nullStream{ &nullBuffer };
+					{
+						IniWriter iniWriter{ nullStream };
+						iniWriter.WriteSettings(*iniSettings);
+					}
+					written = nullBuffer.GetWritten();
+				});
+				measurements.push_back(Measurement{ "write", seconds, written, 0 });
+			}
+
+			return measurements;
+		}
+
+		void PrintMeasurements(std::string_view corpus, const std::vector<Measurement>& measurements, bool csv)
+		{
+			constexpr double megabyte{ 1024.0 * 1024.0 };
+
+			for (const Measurement& measurement : measurements)
+			{
+				double megabytesPerSecond = measurement.bytes / megabyte / measurement.seconds;
+				double operationsPerSecond = measurement.operations / measurement.seconds;
+
+				if (csv)
+				{
+					std::cout << corpus << ',' << measurement.benchmark << ',' << measurement.seconds << ','
+						<< (measurement.bytes ? megabytesPerSecond : 0.0) << ','
+						<< (measurement.operations ? operationsPerSecond : 0.0) << '\n';
+					continue;
+				}
+
+				std::cout << std::left << std::setw(16) << corpus << std::setw(20) << measurement.benchmark << std::right;
+				if (measurement.bytes)
+					std::cout << std::setw(12) << std::fixed << std::setprecision(1) << megabytesPerSecond << " MB/s";
+				else
+					std::cout << std::setw(17) << "";
+				if (measurement.operations)
+					std::cout << std::setw(14) << std::fixed << std::setprecision(0) << operationsPerSecond << " ops/s";
+				std::cout << '\n';
+			}
+		}
+
+		bool ParseOptions(int argc, char** argv, Options& options)
+		{
+			for (int arg = 1; arg < argc; arg++)
+			{
+				std::string_view name{ argv[arg] };
+				bool hasValue = arg + 1 < argc;
+
+				if (name == "--size" && hasValue)
+					options.corpusSize = static_cast<std::size_t>(std::strtod(argv[++arg], nullptr) * 1024 * 1024);
+				else if (name == "--seed" && hasValue)
+					options.seed = std::strtoull(argv[++arg], nullptr, 10);
+				else if (name == "--repetitions" && hasValue)
+					options.repetitions = std::max(1, std::atoi(argv[++arg]));
+				else if (name == "--corpus" && hasValue)
+					options.corpus = argv[++arg];
+				else if (name == "--csv")
+					options.csv = true;
+				else
+					return false;
+			}
+			return true;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace inip::bench;
+
+	Options options{};
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::cerr << "Usage: " << argv[0] << " [--size MB] [--seed N] [--repetitions N] [--corpus NAME] [--csv]\n";
+		std::cerr << "Corpora:";
+		for (CorpusKind corpusKind : AllCorpusKinds())
+			std::cerr << ' ' << CorpusKindToString(corpusKind);
+		std::cerr << '\n';
+		return EXIT_FAILURE;
+	}
+
+	if (options.csv)
+		std::cout << "corpus,benchmark,seconds,mb_per_s,ops_per_s\n";
+
+	for (CorpusKind corpusKind : AllCorpusKinds())
+	{
+		std::string_view corpus = CorpusKindToString(corpusKind);
+		if (!options.corpus.empty() && options.corpus != corpus)
+			continue;
+
+		std::string source = GenerateCorpus(corpusKind, options.corpusSize, options.seed);
+		if (!options.csv)
+			std::cout << "# " << corpus << ": " << source.size() << " bytes, seed " << options.seed << '\n';
+
+		PrintMeasurements(corpus, RunCorpus(source, options), options.csv);
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
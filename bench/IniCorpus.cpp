@@ -0,0 +1,326 @@
+#include "IniCorpus.h"
+
+#include <random>
+
+namespace inip::bench
+{
+	namespace
+	{
+		class Random
+		{
+		public:
+
+			explicit Random(std::uint64_t seed)
+				: engine(seed)
+			{
+			}
+
+			// Slightly biased for huge bounds, which doesn't matter here
+			std::uint64_t Below(std::uint64_t bound)
+			{
+				return engine() % bound;
+			}
+			std::uint64_t Between(std::uint64_t low, std::uint64_t high)
+			{
+				return low + Below(high - low + 1);
+			}
+			bool Chance(unsigned percent)
+			{
+				return Below(100) < percent;
+			}
+
+		private:
+
+			std::mt19937_64 engine;
+		};
+
+		constexpr std::string_view words[]
+		{
+			"server", "client", "timeout", "max", "min", "path", "port", "host", "retry", "count",
+			"buffer", "size", "enable", "level", "log", "cache", "limit", "thread", "pool", "queue",
+			"interval", "user", "name", "mode", "window", "width", "height", "color", "volume", "rate",
+		};
+
+		class CorpusWriter
+		{
+		public:
+
+			CorpusWriter(std::size_t targetSize, std::uint64_t seed)
+				: random(seed), targetSize(targetSize)
+			{
+				source.reserve(targetSize + 64 * 1024);
+			}
+
+			bool Full() const
+			{
+				return source.size() >= targetSize;
+			}
+
+			void Group(std::size_t index)
+			{
+				if (!source.empty())
+					source += '\n';
+				source += '[';
+				Identifier(index);
+				source += "]\n";
+			}
+			void Key(std::size_t index, std::string_view indentation = {})
+			{
+				source += indentation;
+				Identifier(index);
+				source += " = ";
+			}
+
+			void Identifier(std::size_t index)
+			{
+				source += words[random.Below(std::size(words))];
+				source += '_';
+				source += words[random.Below(std::size(words))];
+				source += '_';
+				source += std::to_string(index);
+			}
+			void Integer(std::size_t maxDigits)
+			{
+				std::size_t digits = random.Between(1, maxDigits);
+				source += static_cast<char>('1' + random.Below(9));
+				for (std::size_t digit = 1; digit < digits; digit++)
+					source += static_cast<char>('0' + random.Below(10));
+			}
+			void Float(std::size_t maxDigits)
+			{
+				Integer(maxDigits / 2 + 1);
+				source += '.';
+				Integer(maxDigits / 2 + 1);
+			}
+			void String(std::size_t minSize, std::size_t maxSize, bool structural)
+			{
+				// Structural characters make the scanner stop inside of the string body
+				constexpr std::string_view plain{ "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789.,:-_" };
+				constexpr std::string_view adversarial{ "abcdefghijklmnopqrstuvwxyz []=/*\n\t0123456789" };
+				std::string_view alphabet = structural ? adversarial : plain;
+
+				std::size_t size = random.Between(minSize, maxSize);
+				source += '"';
+				for (std::size_t c = 0; c < size; c++)
+					source += alphabet[random.Below(alphabet.size())];
+				source += '"';
+			}
+			void LineComment(std::size_t maxSize)
+			{
+				source += "// ";
+				std::size_t size = random.Between(4, maxSize);
+				while (size-- > 0)
+					source += static_cast<char>('a' + random.Below(26));
+			}
+			void BlockComment(std::size_t lines)
+			{
+				source += "/*\n";
+				for (std::size_t line = 0; line < lines; line++)
+				{
+					source += " * ";
+					String(10, 60, false);
+					source += '\n';
+				}
+				source += " */";
+			}
+
+			Random random;
+			std::size_t targetSize;
+			std::string source;
+		};
+
+		void GenerateRealistic(CorpusWriter& writer)
+		{
+			for (std::size_t group = 0; !writer.Full(); group++)
+			{
+				if (writer.random.Chance(20))
+				{
+					writer.LineComment(60);
+					writer.source += '\n';
+				}
+				writer.Group(group);
+
+				std::string_view indentation = writer.random.Chance(30) ? "\t" : "";
+				std::size_t options = writer.random.Between(5, 40);
+				for (std::size_t option = 0; option < options; option++)
+				{
+					if (writer.random.Chance(10))
+					{
+						writer.source += indentation;
+						writer.LineComment(50);
+						writer.source += '\n';
+					}
+
+					writer.Key(option, indentation);
+					std::uint64_t type = writer.random.Below(10);
+					if (type < 4)
+						writer.Integer(6);
+					else if (type < 6)
+						writer.Float(8);
+					else if (type < 9)
+						writer.String(4, 40, false);
+					else
+						writer.source += writer.random.Chance(50) ? "true" : "false";
+
+					if (writer.random.Chance(5))
+					{
+						writer.source += ' ';
+						writer.LineComment(30);
+					}
+					writer.source += '\n';
+				}
+			}
+		}
+		void GenerateSmallGroups(CorpusWriter& writer)
+		{
+			for (std::size_t group = 0; !writer.Full(); group++)
+			{
+				writer.Group(group);
+				std::size_t options = writer.random.Between(1, 2);
+				for (std::size_t option = 0; option < options; option++)
+				{
+					writer.Key(option);
+					writer.Integer(4);
+					writer.source += '\n';
+				}
+			}
+		}
+		void GenerateHugeGroups(CorpusWriter& writer)
+		{
+			// Four groups, each a quarter of the source
+			for (std::size_t group = 0; !writer.Full(); group++)
+			{
+				writer.Group(group);
+				std::size_t groupEnd = writer.source.size() + writer.targetSize / 4;
+				for (std::size_t option = 0; writer.source.size() < groupEnd; option++)
+				{
+					writer.Key(option);
+					if (writer.random.Chance(50))
+						writer.Integer(8);
+					else
+						writer.String(4, 24, false);
+					writer.source += '\n';
+				}
+			}
+		}
+		void GenerateLongStrings(CorpusWriter& writer)
+		{
+			for (std::size_t group = 0; !writer.Full(); group++)
+			{
+				writer.Group(group);
+				std::size_t options = writer.random.Between(2, 10);
+				for (std::size_t option = 0; option < options; option++)
+				{
+					writer.Key(option);
+					writer.String(1024, 16 * 1024, writer.random.Chance(50));
+					writer.source += '\n';
+				}
+			}
+		}
+		void GenerateCommentHeavy(CorpusWriter& writer)
+		{
+			for (std::size_t group = 0; !writer.Full(); group++)
+			{
+				writer.BlockComment(writer.random.Between(1, 6));
+				writer.source += '\n';
+				writer.Group(group);
+
+				std::size_t options = writer.random.Between(3, 20);
+				for (std::size_t option = 0; option < options; option++)
+				{
+					std::size_t comments = writer.random.Between(1, 3);
+					for (std::size_t comment = 0; comment < comments; comment++)
+					{
+						writer.LineComment(80);
+						writer.source += '\n';
+					}
+
+					writer.Key(option);
+					writer.Integer(5);
+					writer.source += ' ';
+					writer.LineComment(40);
+					writer.source += '\n';
+				}
+			}
+		}
+		void GenerateNumericHeavy(CorpusWriter& writer)
+		{
+			for (std::size_t group = 0; !writer.Full(); group++)
+			{
+				writer.Group(group);
+				std::size_t options = writer.random.Between(10, 60);
+				for (std::size_t option = 0; option < options; option++)
+				{
+					writer.Key(option);
+					if (writer.random.Chance(50))
+						writer.Integer(18);
+					else
+						writer.Float(16);
+					writer.source += '\n';
+				}
+			}
+		}
+	}
+
+	std::vector<CorpusKind> AllCorpusKinds()
+	{
+		return {
+			CorpusKind::REALISTIC,
+			CorpusKind::SMALL_GROUPS,
+			CorpusKind::HUGE_GROUPS,
+			CorpusKind::LONG_STRINGS,
+			CorpusKind::COMMENT_HEAVY,
+			CorpusKind::NUMERIC_HEAVY,
+		};
+	}
+
+	std::string_view CorpusKindToString(CorpusKind corpusKind)
+	{
+		switch (corpusKind)
+		{
+		case CorpusKind::REALISTIC:
+			return "realistic";
+		case CorpusKind::SMALL_GROUPS:
+			return "small-groups";
+		case CorpusKind::HUGE_GROUPS:
+			return "huge-groups";
+		case CorpusKind::LONG_STRINGS:
+			return "long-strings";
+		case CorpusKind::COMMENT_HEAVY:
+			return "comment-heavy";
+		case CorpusKind::NUMERIC_HEAVY:
+			return "numeric-heavy";
+		}
+		return "unidentified";
+	}
+
+	std::string GenerateCorpus(CorpusKind corpusKind, std::size_t targetSize, std::uint64_t seed)
+	{
+		// Every kind gets a stream of its own, the same seed doesn't give related corpora
+		CorpusWriter writer{ targetSize, seed * 31 + static_cast<std::uint64_t>(corpusKind) };
+
+		switch (corpusKind)
+		{
+		case CorpusKind::REALISTIC:
+			GenerateRealistic(writer);
+			break;
+		case CorpusKind::SMALL_GROUPS:
+			GenerateSmallGroups(writer);
+			break;
+		case CorpusKind::HUGE_GROUPS:
+			GenerateHugeGroups(writer);
+			break;
+		case CorpusKind::LONG_STRINGS:
+			GenerateLongStrings(writer);
+			break;
+		case CorpusKind::COMMENT_HEAVY:
+			GenerateCommentHeavy(writer);
+			break;
+		case CorpusKind::NUMERIC_HEAVY:
+			GenerateNumericHeavy(writer);
+			break;
+		}
+
+		return std::move(writer.source);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inip::bench
+{
+	// Synthetic sources for the benchmarks.
+	// A generator only uses its own arithmetic on top of std::mt19937_64 (whose output is fixed by the standard),
+	// so a seed gives the same text with every compiler and standard library.
+
+	enum class CorpusKind
+	{
+		// Groups of a few dozen options of mixed types, some comments and indentation
+		REALISTIC,
+		// Lots of groups with one or two options each
+		SMALL_GROUPS,
+		// A handful of groups with a huge number of options each
+		HUGE_GROUPS,
+		// Kilobytes long strings full of structural characters
+		LONG_STRINGS,
+		// More comment than content, line and block comments
+		COMMENT_HEAVY,
+		// Integers and floats only, long numbers
+		NUMERIC_HEAVY,
+	};
+
+	std::vector<CorpusKind> AllCorpusKinds();
+	std::string_view CorpusKindToString(CorpusKind corpusKind);
+
+	// Generates a source of roughly 'targetSize' bytes
+	std::string GenerateCorpus(CorpusKind corpusKind, std::size_t targetSize, std::uint64_t seed);
+}
\ No newline at end of file
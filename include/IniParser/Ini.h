@@ -1,23 +1,32 @@
 #pragma once
 
+#include <charconv>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <typeinfo>
 #include <type_traits>
-#include <unordered_map>
+#include <variant>
 #include <vector>
 
+#include "IniArena.h"
 #include "IniError.h"
+#include "IniFlatMap.h"
 #include "IniParserApi.h"
+#include "IniSymbolTable.h"
 
 namespace inip
 {
 	enum IniOptionType
 	{
 		UNIDENTIFIED,
-		STRING, INTEGER, FLOAT
+		STRING, INTEGER, FLOAT,
+		// Comma separated values, 'IniOption::GetArray' reads them
+		LIST
 	};
 
 	class IniOption;
@@ -26,14 +35,30 @@ namespace inip
 
 	// Helper functions
 
+	// Big enough for any integer and for the shortest round-trip form of a double
+	constexpr std::size_t numberBufferSize{ 64 };
+
+	// Writes 'value' with std::to_chars, returns the end of the written characters
+	template <
+		typename T,
+		std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+	char* FormatNumber(char* buffer, const T& value)
+	{
+		std::to_chars_result result{};
+		if constexpr (std::is_same_v<T, bool>)
+			result = std::to_chars(buffer, buffer + numberBufferSize, static_cast<int>(value));
+		else
+			result = std::to_chars(buffer, buffer + numberBufferSize, value);
+		return result.ptr;
+	}
+
 	template <
 		typename T,
 		std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
 	std::string Stringify(const T& value)
 	{
-		std::stringstream sstream;
-		sstream << value;
-		return sstream.str();
+		char buffer[numberBufferSize];
+		return std::string(buffer, FormatNumber(buffer, value));
 	}
 
 	template <
@@ -46,90 +71,314 @@ namespace inip
 		return value;
 	}
 
+	template <typename T>
+	constexpr IniOptionType DeduceOptionType()
+	{
+		if constexpr (std::is_integral_v<T>)
+			return IniOptionType::INTEGER;
+		else if constexpr (std::is_floating_point_v<T>)
+			return IniOptionType::FLOAT;
+		else
+			return IniOptionType::STRING;
+	}
+
+	// Whether an integral 'T' holds 'value'
+	template <
+		typename T,
+		std::enable_if_t<std::is_integral_v<T>, bool> = true>
+	constexpr bool IntegerFits(long long value)
+	{
+		if constexpr (std::is_signed_v<T>)
+			return value >= std::numeric_limits<T>::lowest() && value <= std::numeric_limits<T>::max();
+		else
+			return value >= 0 && static_cast<unsigned long long>(value) <= std::numeric_limits<T>::max();
+	}
+
+	// Whether 'value' truncated toward zero fits into an integral 'T', NaN doesn't.
+	// The bounds are compared against 2^digits, which a double holds exactly,
+	// 'max()' of a 64 bit type rounds up to it and would let it through.
+	template <
+		typename T,
+		std::enable_if_t<std::is_integral_v<T>, bool> = true>
+	constexpr bool FloatFits(double value)
+	{
+		constexpr double upperBound{ static_cast<double>(std::numeric_limits<T>::max() / 2 + 1) * 2.0 };
+		if constexpr (std::is_signed_v<T>)
+			return value >= -upperBound && value < upperBound;
+		else
+			return value > -1.0 && value < upperBound;
+	}
+
+	// Numeric reads shared by 'IniOption' and 'IniCompiledOption', an arithmetic 'T' that can't hold the value
+	// is reported as a 'VALUE_CAST_ERROR'
+
+	template <
+		typename T,
+		std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+	IniResult<T> ConvertInteger(long long value) noexcept
+	{
+		if constexpr (std::is_integral_v<T>)
+		{
+			if (!IntegerFits<T>(value))
+				return IniErrorCode::VALUE_CAST_ERROR;
+		}
+		return static_cast<T>(value);
+	}
+
+	template <
+		typename T,
+		std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+	IniResult<T> ConvertFloat(double value) noexcept
+	{
+		if constexpr (std::is_integral_v<T>)
+		{
+			if (!FloatFits<T>(value))
+				return IniErrorCode::VALUE_CAST_ERROR;
+		}
+		return static_cast<T>(value);
+	}
+
+	// Parsed with std::from_chars, the whole text must be a number (no whitespace, no '+')
+	template <
+		typename T,
+		std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+	IniResult<T> ParseNumber(std::string_view text) noexcept
+	{
+		std::conditional_t<std::is_integral_v<T>, long long, double> value{};
+		auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+		if (ec != std::errc{} || ptr != text.data() + text.size())
+			return IniErrorCode::VALUE_CAST_ERROR;
+		if constexpr (std::is_integral_v<T>)
+			return ConvertInteger<T>(value);
+		else
+			return static_cast<T>(value);
+	}
+
 	INI_PARSER_API std::string IniOptionTypeToString(IniOptionType optionType);
 
+	// Ini Key
+
+	// Key whose hash is computed at compile time, for keys that are looked up over and over:
+	//     constexpr inip::IniKey timeoutKey{ "timeout" };
+	//     using namespace inip::literals; auto key = "timeout"_key;
+
+	class IniKey
+	{
+	public:
+
+		constexpr explicit IniKey(std::string_view name)
+			: name(name), hash(HashKey(name)) {}
+		// An interned name is looked up with the hash the symbol table computed
+		constexpr IniKey(const IniSymbol& symbol)
+			: name(symbol.GetName()), hash(symbol.GetHash()) {}
+
+		constexpr std::string_view GetName() const
+		{
+			return name;
+		}
+		constexpr std::uint64_t GetHash() const
+		{
+			return hash;
+		}
+
+	private:
+
+		std::string_view name;
+		std::uint64_t hash;
+	};
+
+	// Key that also fixes the type its value is read as, so typed lookups need no template argument
+	// and an unsupported type is rejected at compile time:
+	//     constexpr inip::IniTypedKey<int> maxConnections{ "max_connections" };
+	//     int value = group->GetOptionValue(maxConnections);
+	// 'std::string_view' keys work with 'GetOptionValue' and 'TryGetOptionValue',
+	// 'std::string' keys only with 'GetOptionValue' (the 'TryGet' family doesn't allocate).
+
+	template <typename T>
+	class IniTypedKey : public IniKey
+	{
+	public:
+
+		static_assert(
+			std::is_integral_v<T> || std::is_floating_point_v<T> ||
+			std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>,
+			"An option's value can only be read as an integral, a floating point or a string type!");
+
+		using ValueType = T;
+
+		static constexpr IniOptionType optionType{ DeduceOptionType<T>() };
+
+		constexpr explicit IniTypedKey(std::string_view name)
+			: IniKey(name) {}
+	};
+
+	namespace literals
+	{
+		constexpr IniKey operator""_key(const char* name, std::size_t size)
+		{
+			return IniKey{ std::string_view{ name, size } };
+		}
+	}
+
+	// Ini Array View
+
+	// Read-only view of the contiguous elements of a list, a stand-in for C++20's std::span.
+	// It's valid as long as the option it was taken from is alive and isn't set.
+
+	template <typename T>
+	class IniArrayView
+	{
+	public:
+
+		constexpr IniArrayView() = default;
+		constexpr IniArrayView(const T* elements, std::size_t elementsCount)
+			: elements(elements), elementsCount(elementsCount) {}
+
+		constexpr const T* data() const
+		{
+			return elements;
+		}
+		constexpr std::size_t size() const
+		{
+			return elementsCount;
+		}
+		constexpr bool empty() const
+		{
+			return elementsCount == 0;
+		}
+
+		constexpr const T* begin() const
+		{
+			return elements;
+		}
+		constexpr const T* end() const
+		{
+			return elements + elementsCount;
+		}
+
+		constexpr const T& operator[](std::size_t index) const
+		{
+			return elements[index];
+		}
+
+	private:
+
+		const T* elements{ nullptr };
+		std::size_t elementsCount{ 0 };
+	};
+
+	// A single element of a list, as the parser hands it to 'IniGroup::CreateListOption'.
+	// STRING elements come without their quotes.
+
+	struct IniListElement
+	{
+		std::string_view text;
+		IniOptionType elementType{ IniOptionType::UNIDENTIFIED };
+	};
+
 	// Ini Option
 
+	// INTEGER and FLOAT values are converted once, when the option is created (or set),
+	// and kept next to their text, so typed reads don't parse the text again.
+	// A numeric text that can't be converted is reported right away with 'IniSettingValueCastError'.
+	// LIST values are converted the same way, in a single pass into one array of their widest element type:
+	// 'long long' if every element is an INTEGER, 'double' if some are FLOATs, 'std::string_view' otherwise.
+
 	class IniOption
 	{
 	public:
 
 		INI_PARSER_API IniOption(const std::string& key)
-			: key(key) {}
+			: key(key, std::pmr::get_default_resource()) {}
 		INI_PARSER_API IniOption(const std::string& key, IniOptionType optionType)
-			: key(key), optionType(optionType) {}
+			: key(key, std::pmr::get_default_resource()), optionType(optionType) {}
 
 		INI_PARSER_API IniOption(
 			const std::string& key,
 			const std::string& value,
 			IniOptionType optionType)
-			: key(key), value(value), optionType(optionType) {}
-
-		template<
-			typename T,
-			std::enable_if_t<std::is_integral_v<T>, bool> = true>
-		IniOption(const std::string& key, const T& value)
-			: key(key), value(Stringify(value)), optionType(IniOptionType::INTEGER) {}
+			: key(key, std::pmr::get_default_resource()), value(value), optionType(optionType)
+		{
+			ConvertValue();
+		}
 
 		template<
 			typename T,
-			std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
 		IniOption(const std::string& key, const T& value)
-			: key(key), value(Stringify(value)), optionType(IniOptionType::FLOAT) {}
+			: key(key, std::pmr::get_default_resource())
+		{
+			SetValue<T>(value);
+		}
 
 		template<
 			typename T,
 			std::enable_if_t<std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, std::string>, bool> = true>
 		IniOption(const std::string& key, const T& value)
-			: key(key), value(value), optionType(IniOptionType::STRING) {}
+			: key(key, std::pmr::get_default_resource()), value(value), optionType(IniOptionType::STRING) {}
 
-		INI_PARSER_API const std::string& GetKey() const
+		// Allocates the key and the value from 'resource', used for options that live in an arena
+		INI_PARSER_API IniOption(
+			std::string_view key,
+			std::string_view value,
+			IniOptionType optionType,
+			std::pmr::memory_resource* resource)
+			: key(key, resource), value(value, resource), optionType(optionType)
 		{
-			return key;
+			ConvertValue();
 		}
 
-		template <
-			typename T,
-			std::enable_if_t<std::is_integral_v<T>, bool> = true>
-		T GetValue() const
+		// The key is interned in a symbol table, options of groups that have one are built this way
+		INI_PARSER_API IniOption(
+			const IniSymbol& key,
+			std::string_view value,
+			IniOptionType optionType,
+			std::pmr::memory_resource* resource)
+			: key(key), value(value, resource), optionType(optionType)
 		{
-			T val{};
-			try
-			{
-				val = static_cast<T>(std::stoll(value));
-			}
-			catch (std::invalid_argument iae)
-			{
-				throw IniSettingValueCastError(key, value, IniOptionTypeToString(optionType));
-			}
-			catch (std::out_of_range oore)
-			{
-				throw IniSettingValueCastError(key, value, IniOptionTypeToString(optionType));
-			}
-			return val;
+			ConvertValue();
 		}
-		
+
+		// Builds a LIST option from its elements, allocated from 'resource'.
+		// Its text is the elements joined with ", ", STRING elements quoted.
+		INI_PARSER_API IniOption(
+			std::string_view key,
+			const std::vector<IniListElement>& elements,
+			std::pmr::memory_resource* resource);
+		INI_PARSER_API IniOption(
+			const IniSymbol& key,
+			const std::vector<IniListElement>& elements,
+			std::pmr::memory_resource* resource);
+
+		// STRING elements of a list are views into the option's text, copies point them at their own.
+		// A copy owns its key, an interned one included.
+		INI_PARSER_API IniOption(const IniOption& other);
+		INI_PARSER_API IniOption& operator=(const IniOption& other);
+
+		INI_PARSER_API std::string_view GetKey() const
+		{
+			return key.GetText();
+		}
+		// 'noSymbol' unless the key is interned
+		INI_PARSER_API IniSymbolId GetKeySymbol() const
+		{
+			return key.GetSymbolId();
+		}
+
+		// Numbers are read through 'TryGetValue', so both accept the same text.
+		// A value 'T' can't hold is rejected rather than wrapped around.
+
 		template <
 			typename T,
-			std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
 		T GetValue() const
 		{
-			T val{};
-			try
-			{
-				val = static_cast<T>(std::stold(value));
-			}
-			catch (std::invalid_argument iae)
-			{
-				throw IniSettingValueCastError(key, value, IniOptionTypeToString(optionType));
-			}
-			catch (std::out_of_range oore)
-			{
-				throw IniSettingValueCastError(key, value, IniOptionTypeToString(optionType));
-			}
-			return val;
+			IniResult<T> result = TryGetValue<T>();
+			if (!result)
+				throw IniSettingValueCastError(std::string{ key.GetText() }, std::string{ value }, IniOptionTypeToString(optionType));
+			return result.GetValue();
 		}
-		
+
 		template <
 			typename T,
 			std::enable_if_t<
@@ -137,7 +386,75 @@ namespace inip
 				bool> = true>
 		T GetValue() const
 		{
-			return value;
+			return std::string{ std::string_view{ value } };
+		}
+		// A view of the option's text, valid as long as the option is
+		template <
+			typename T,
+			std::enable_if_t<std::is_same_v<T, std::string_view>, bool> = true>
+		T GetValue() const
+		{
+			return std::string_view{ value };
+		}
+
+		// Non-throwing counterparts of 'GetValue', STRING options are parsed with 'ParseNumber'.
+		// A string value is returned as a view of the option's text, nothing is allocated.
+
+		template <
+			typename T,
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+		IniResult<T> TryGetValue() const noexcept
+		{
+			if (optionType == IniOptionType::INTEGER)
+				return ConvertInteger<T>(integerValue);
+			if (optionType == IniOptionType::FLOAT)
+				return ConvertFloat<T>(floatValue);
+			return ParseNumber<T>(value);
+		}
+
+		template <
+			typename T,
+			std::enable_if_t<std::is_same_v<T, std::string_view>, bool> = true>
+		IniResult<T> TryGetValue() const noexcept
+		{
+			return std::string_view{ value };
+		}
+
+		// The elements of a LIST option, 'T' must be its element type ('long long', 'double' or 'std::string_view').
+		// An INTEGER or a FLOAT option reads as a list of a single element.
+		// A list is written unquoted ('ports = 80, 443, 8080'), a quoted "80,443,8080" is a STRING
+		// and reads as one, as strings may hold commas of their own.
+
+		template <typename T>
+		IniArrayView<T> GetArray() const
+		{
+			IniResult<IniArrayView<T>> elements = TryGetArray<T>();
+			if (!elements)
+				throw IniSettingValueCastError(std::string{ key.GetText() }, std::string{ value }, IniOptionTypeToString(optionType));
+			return elements.GetValue();
+		}
+
+		template <typename T>
+		IniResult<IniArrayView<T>> TryGetArray() const noexcept
+		{
+			static_assert(
+				std::is_same_v<T, long long> || std::is_same_v<T, double> || std::is_same_v<T, std::string_view>,
+				"A list's elements can only be read as 'long long', 'double' or 'std::string_view'!");
+
+			if constexpr (std::is_same_v<T, long long>)
+			{
+				if (optionType == IniOptionType::INTEGER)
+					return IniArrayView<T>{ &integerValue, 1 };
+			}
+			else if constexpr (std::is_same_v<T, double>)
+			{
+				if (optionType == IniOptionType::FLOAT)
+					return IniArrayView<T>{ &floatValue, 1 };
+			}
+
+			if (const auto* elements = std::get_if<std::pmr::vector<T>>(&array))
+				return IniArrayView<T>{ elements->data(), elements->size() };
+			return IniErrorCode::VALUE_CAST_ERROR;
 		}
 
 		template <
@@ -145,14 +462,20 @@ namespace inip
 			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
 		void SetValue(const T& numericValue)
 		{
-			if (std::is_integral_v<T>)
+			array = std::monostate{};
+			if constexpr (std::is_integral_v<T>)
+			{
 				optionType = IniOptionType::INTEGER;
-			else if (std::is_floating_point_v<T>)
+				integerValue = static_cast<long long>(numericValue);
+			}
+			else
+			{
 				optionType = IniOptionType::FLOAT;
+				floatValue = static_cast<double>(numericValue);
+			}
 
-			std::stringstream ostream;
-			ostream << numericValue;
-			this->value = ostream.str();
+			char buffer[numberBufferSize];
+			this->value.assign(buffer, FormatNumber(buffer, numericValue));
 		}
 		
 		template <
@@ -162,6 +485,7 @@ namespace inip
 				bool> = true>
 		void SetValue(const std::string& strValue)
 		{
+			array = std::monostate{};
 			optionType = IniOptionType::STRING;
 			this->value = strValue;
 		}
@@ -173,70 +497,343 @@ namespace inip
 
 	private:
 
-		std::string key;
-		std::string value;
+		INI_PARSER_API void ConvertValue();
+		INI_PARSER_API void ConvertList(const std::vector<IniListElement>& elements);
+		void CopyFrom(const IniOption& other);
+
+		IniName key;
+		std::pmr::string value;
+
+		// Binary form of INTEGER and FLOAT values
+		union
+		{
+			long long integerValue{ 0 };
+			double floatValue;
+		};
+
+		// Elements of a LIST value, STRING ones view 'value'
+		std::variant<
+			std::monostate,
+			std::pmr::vector<long long>,
+			std::pmr::vector<double>,
+			std::pmr::vector<std::string_view>> array;
 
 		IniOptionType optionType{ IniOptionType::UNIDENTIFIED };
 	};
 
 	// Ini Group
 
+	// Options are allocated in the arena the group lives in.
+	// A group created on its own owns a private arena, groups created through 'IniSettings::CreateGroup'
+	// share the arena of their settings, so a whole settings tree is freed with a handful of deallocations.
+	// 'Find*' functions return non-owning pointers that stay valid as long as the arena is alive,
+	// 'Get*' functions return shared pointers that keep the arena alive.
+
 	class IniGroup
 	{
 	public:
 
 		INI_PARSER_API IniGroup(const std::string& iniGroupName);
+		// With a symbol table the group's name and the keys of the options it creates are interned
+		INI_PARSER_API IniGroup(std::string_view iniGroupName, IniArena& arena, IniSymbolTable* symbolTable = nullptr);
+
+		IniGroup(const IniGroup&) = delete;
+		IniGroup& operator=(const IniGroup&) = delete;
 
 		template <typename T>
-		void AddOption(const std::string& key, const T& value)
+		void AddOption(std::string_view key, const T& value)
 		{
-			std::shared_ptr<IniOption> option = std::make_shared<IniOption>(key, Stringify(value));
-			AddOption(option);
+			CreateOption(key, Stringify<T>(value), DeduceOptionType<T>());
 		}
+		// The option isn't copied, the group keeps it alive instead
 		INI_PARSER_API void AddOption(std::shared_ptr<IniOption> option);
 
-		INI_PARSER_API bool OptionExists(const std::string& key) const;
+		// Builds an option in the group's arena.
+		// Like 'AddOption', the first option with a given key wins, a duplicate is created but not registered.
+		INI_PARSER_API IniOption& CreateOption(std::string_view key, std::string_view value, IniOptionType optionType);
+		// Builds a LIST option in the group's arena, registered like 'CreateOption' does
+		INI_PARSER_API IniOption& CreateListOption(std::string_view key, const std::vector<IniListElement>& elements);
+
+		// Lookups take 'std::string_view', so literals and slices of other buffers
+		// are looked up as they are, without building a temporary std::string
 
-		INI_PARSER_API std::shared_ptr<IniOption> GetOption(const std::string& key) const;
+		INI_PARSER_API bool OptionExists(std::string_view key) const;
+
+		INI_PARSER_API std::shared_ptr<IniOption> GetOption(std::string_view key) const;
+		INI_PARSER_API IniOption* FindOption(std::string_view key) const noexcept;
+		// Skips hashing, the key's hash was computed at compile time
+		INI_PARSER_API IniOption* FindOption(const IniKey& key) const noexcept;
 
 		template <typename T>
-		T GetOptionValue(const std::string& key) const
+		T GetOptionValue(std::string_view key) const
 		{
-			std::shared_ptr<IniOption> option = GetOption(key);
+			IniOption* option = FindOption(key);
 			if (!option)
-				throw IniSettingOptionNotFoundError{ key };
+				throw IniSettingOptionNotFoundError{ std::string{ key } };
 			return option->GetValue<T>();
 		}
 
+		template <typename T>
+		T GetOptionValue(const IniKey& key) const
+		{
+			IniOption* option = FindOption(key);
+			if (!option)
+				throw IniSettingOptionNotFoundError{ std::string{ key.GetName() } };
+			return option->GetValue<T>();
+		}
+		template <typename T>
+		T GetOptionValue(const IniTypedKey<T>& key) const
+		{
+			return GetOptionValue<T>(static_cast<const IniKey&>(key));
+		}
+
+		// Doesn't throw nor allocate, a missing key or a failed cast is reported through the result
+		template <typename T>
+		IniResult<T> TryGetOptionValue(std::string_view key) const noexcept
+		{
+			const IniOption* option = FindOption(key);
+			if (!option)
+				return IniErrorCode::OPTION_NOT_FOUND;
+			return option->TryGetValue<T>();
+		}
+		template <typename T>
+		IniResult<T> TryGetOptionValue(const IniKey& key) const noexcept
+		{
+			const IniOption* option = FindOption(key);
+			if (!option)
+				return IniErrorCode::OPTION_NOT_FOUND;
+			return option->TryGetValue<T>();
+		}
+		template <typename T>
+		IniResult<T> TryGetOptionValue(const IniTypedKey<T>& key) const noexcept
+		{
+			static_assert(
+				!std::is_same_v<T, std::string>,
+				"'TryGetOptionValue' doesn't allocate, read a string through an 'IniTypedKey<std::string_view>'!");
+			return TryGetOptionValue<T>(static_cast<const IniKey&>(key));
+		}
+
 		INI_PARSER_API std::vector<std::shared_ptr<IniOption>> GetGroupOptions() const;
 
-		INI_PARSER_API const std::string& GetGroupName() const;
+		// Visits the options in file order without sharing them, 'function' takes a 'const IniOption&'
+		template <typename Function>
+		void ForEachOption(Function&& function) const
+		{
+			for (const auto& entry : options)
+			{
+				function(static_cast<const IniOption&>(*entry.value));
+			}
+		}
+
+		INI_PARSER_API std::string_view GetGroupName() const;
+		// 'noSymbol' unless the name is interned
+		INI_PARSER_API IniSymbolId GetGroupNameSymbol() const;
+
+		// Changes whenever an option is registered, options are never removed so it's simply their count
+		std::uint64_t GetGeneration() const
+		{
+			return options.Size();
+		}
 
 	private:
 
-		std::unordered_map<std::string, std::shared_ptr<IniOption>> options;
-		std::string iniGroupName;
+		std::shared_ptr<IniArena> ownedArena;
+		IniArena* arena{ nullptr };
+		// Kept alive by the settings the group belongs to
+		IniSymbolTable* symbolTable{ nullptr };
+
+		// Insertion (file) order
+		IniFlatMap<IniOption> options;
+		IniName iniGroupName;
+	};
+
+	// Ini Group Loader
+
+	// Builds groups of settings the first time they're looked up, lazy parses install one ('IniParseMode::LAZY').
+	// Implementations must be safe to call from several threads at once.
+
+	class IniGroupLoader
+	{
+	public:
+
+		virtual ~IniGroupLoader() = default;
+
+		// Null if the source has no such group, throws if the group can't be built
+		virtual IniGroup* LoadGroup(std::string_view groupName, std::uint64_t hash) = 0;
+		// Every group in file order, the ones that weren't looked up yet are built first
+		virtual std::vector<IniGroup*> LoadGroups() = 0;
 	};
 
 	// Ini Settings
 
+	// Groups of a loader are looked up after the groups the settings hold themselves.
+	// Visiting or listing all the groups builds every group of the loader.
+
 	class IniSettings
 	{
 	public:
 
 		INI_PARSER_API IniSettings(const std::string& iniSettingsName);
 
+		// The group isn't copied, the settings keep it alive instead
 		INI_PARSER_API void AddGroup(std::shared_ptr<IniGroup> iniGroup);
-		INI_PARSER_API std::shared_ptr<IniGroup> GetGroup(const std::string& groupName) const;
+		// Adds every group of 'iniSettings' in order, the groups aren't copied either
+		INI_PARSER_API void AddGroups(std::shared_ptr<IniSettings> iniSettings);
+
+		// Builds a group in the settings' arena.
+		// Like 'AddGroup', the first group with a given name wins, a duplicate is created but not registered.
+		INI_PARSER_API IniGroup& CreateGroup(std::string_view groupName);
+
+		// Kept alive by the settings' arena
+		INI_PARSER_API void SetGroupLoader(std::shared_ptr<IniGroupLoader> groupLoader);
+		// Groups created afterwards intern their names and keys in 'symbolTable', kept alive by the settings' arena.
+		// Settings that share a table store every distinct name once, and interned keys compare by address.
+		INI_PARSER_API void SetSymbolTable(std::shared_ptr<IniSymbolTable> symbolTable);
+
+		// Throws what the loader throws for a group it can't build
+		INI_PARSER_API std::shared_ptr<IniGroup> GetGroup(std::string_view groupName) const;
+		// A group the loader can't build isn't found
+		INI_PARSER_API IniGroup* FindGroup(std::string_view groupName) const noexcept;
+		// Skips hashing, the name's hash was computed at compile time
+		INI_PARSER_API IniGroup* FindGroup(const IniKey& groupName) const noexcept;
+
+		// Doesn't throw nor allocate, a missing group or key or a failed cast is reported through the result
+		template <typename T>
+		IniResult<T> TryGetOptionValue(std::string_view groupName, std::string_view key) const noexcept
+		{
+			const IniGroup* group = FindGroup(groupName);
+			if (!group)
+				return IniErrorCode::GROUP_NOT_FOUND;
+			return group->TryGetOptionValue<T>(key);
+		}
+		template <typename T>
+		IniResult<T> TryGetOptionValue(const IniKey& groupName, const IniTypedKey<T>& key) const noexcept
+		{
+			const IniGroup* group = FindGroup(groupName);
+			if (!group)
+				return IniErrorCode::GROUP_NOT_FOUND;
+			return group->TryGetOptionValue(key);
+		}
 
 		INI_PARSER_API std::vector<std::shared_ptr<IniGroup>> GetSettingsGroups() const;
 
+		// Visits the groups in file order without sharing them, 'function' takes a 'const IniGroup&'
+		template <typename Function>
+		void ForEachGroup(Function&& function) const
+		{
+			for (const auto& entry : groups)
+			{
+				function(static_cast<const IniGroup&>(*entry.value));
+			}
+			if (!groupLoader)
+				return;
+			for (IniGroup* group : groupLoader->LoadGroups())
+			{
+				if (!groups.Find(group->GetGroupName()))
+					function(static_cast<const IniGroup&>(*group));
+			}
+		}
+
 		INI_PARSER_API const std::string& GetIniSettingsName() const;
 
+		INI_PARSER_API const IniArena& GetArena() const;
+
+		// Changes whenever a group is registered or a loader is set (options added to a group change the group's).
+		// Generations are drawn from a counter shared by all settings, so no two settings ever have the same one
+		// and settings that replace others are told apart from them.
+		std::uint64_t GetGeneration() const
+		{
+			return generation;
+		}
+
 	private:
 
-		std::unordered_map<std::string, std::shared_ptr<IniGroup>> groups;
+		std::shared_ptr<IniArena> arena;
+
+		IniGroup* LoadGroup(std::string_view groupName, std::uint64_t hash) const;
+
+		// Insertion (file) order
+		IniFlatMap<IniGroup> groups;
 		std::string iniSettingsName;
+
+		// Null unless the groups are built on demand
+		IniGroupLoader* groupLoader{ nullptr };
+		// Null unless names are interned
+		IniSymbolTable* symbolTable{ nullptr };
+
+		std::uint64_t generation{ 0 };
+	};
+
+	// Ini Option Handle
+
+	// Option looked up once and then read directly, for reads on a hot path:
+	//     inip::IniOptionHandle timeout{ inip::IniKey{ "net" }, inip::IniKey{ "timeout" } };
+	//     int value = timeout.GetValue<int>(*iniSettings);
+	// The handle keeps what it found along with the generations of the settings and the group.
+	// It's looked up again only when they changed: other settings were passed (a reload replaced them),
+	// or a group or, while the option is missing, an option was added. Values set in place are read as they are.
+	// A handle doesn't keep the settings alive and isn't safe to use from several threads at once, each thread needs its own.
+
+	class IniOptionHandle
+	{
+	public:
+
+		constexpr IniOptionHandle(const IniKey& groupName, const IniKey& key)
+			: groupName(groupName), key(key) {}
+
+		// Null if the settings have no such group or option
+		const IniOption* Find(const IniSettings& iniSettings) noexcept
+		{
+			if (iniSettings.GetGeneration() != settingsGeneration ||
+				(!option && group && group->GetGeneration() != groupGeneration))
+			{
+				Resolve(iniSettings);
+			}
+			return option;
+		}
+
+		template <typename T>
+		T GetValue(const IniSettings& iniSettings)
+		{
+			const IniOption* iniOption = Find(iniSettings);
+			if (!iniOption)
+				throw IniSettingOptionNotFoundError{ std::string{ key.GetName() } };
+			return iniOption->GetValue<T>();
+		}
+
+		// Doesn't throw nor allocate, a missing group or key or a failed cast is reported through the result
+		template <typename T>
+		IniResult<T> TryGetValue(const IniSettings& iniSettings) noexcept
+		{
+			const IniOption* iniOption = Find(iniSettings);
+			if (!iniOption)
+				return group ? IniErrorCode::OPTION_NOT_FOUND : IniErrorCode::GROUP_NOT_FOUND;
+			return iniOption->TryGetValue<T>();
+		}
+
+		constexpr const IniKey& GetGroupName() const
+		{
+			return groupName;
+		}
+		constexpr const IniKey& GetKey() const
+		{
+			return key;
+		}
+
+	private:
+
+		INI_PARSER_API void Resolve(const IniSettings& iniSettings) noexcept;
+
+		IniKey groupName;
+		IniKey key;
+
+		// 0 until the handle is first used, settings never have generation 0
+		std::uint64_t settingsGeneration{ 0 };
+		std::uint64_t groupGeneration{ 0 };
+
+		// Owned by the settings last passed in
+		const IniGroup* group{ nullptr };
+		const IniOption* option{ nullptr };
 	};
 
 	// Ini Settings printer?
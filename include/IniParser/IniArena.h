@@ -0,0 +1,88 @@
+#pragma once
+
+#include "IniParserApi.h"
+
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace inip
+{
+	// Bump allocator that owns the nodes of a settings tree.
+	// Objects are carved out of a few large blocks and released all at once with the arena,
+	// objects that have a destructor get it called when the arena goes away.
+	// Allocator-aware members (std::pmr containers and strings) should use 'GetResource'
+	// so their storage lands in the same blocks.
+
+	class IniArena : public std::enable_shared_from_this<IniArena>
+	{
+	public:
+
+		INI_PARSER_API IniArena();
+		INI_PARSER_API ~IniArena();
+
+		IniArena(const IniArena&) = delete;
+		IniArena& operator=(const IniArena&) = delete;
+
+		template <typename T, typename... Args>
+		T* Create(Args&&... args)
+		{
+			void* memory = resource.allocate(sizeof(T), alignof(T));
+			T* object = new (memory) T(std::forward<Args>(args)...);
+			if constexpr (!std::is_trivially_destructible_v<T>)
+			{
+				destructors.push_back({ object, [](void* object) { static_cast<T*>(object)->~T(); } });
+			}
+			return object;
+		}
+
+		// Owning pointer to an object of the arena, it keeps the whole arena alive
+		template <typename T>
+		std::shared_ptr<T> Share(T* object)
+		{
+			return std::shared_ptr<T>(shared_from_this(), object);
+		}
+
+		// Keeps an object that was allocated elsewhere alive as long as the arena
+		INI_PARSER_API void Adopt(std::shared_ptr<const void> object);
+
+		INI_PARSER_API std::pmr::memory_resource* GetResource();
+
+		// What the arena took from the heap so far, adopted objects aren't included
+		INI_PARSER_API std::size_t GetAllocatedBytes() const;
+		INI_PARSER_API std::size_t GetAllocationsCount() const;
+
+	private:
+
+		// Forwards to the default resource and counts the blocks the arena asks for
+		class CountingResource : public std::pmr::memory_resource
+		{
+		public:
+
+			std::size_t allocatedBytes{ 0 };
+			std::size_t allocationsCount{ 0 };
+
+		private:
+
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+			void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override;
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+		};
+
+		struct Destructor
+		{
+			void* object;
+			void (*destroy)(void* object);
+		};
+
+		static constexpr std::size_t initialBlockSize{ 4096 };
+
+		CountingResource upstream;
+		std::pmr::monotonic_buffer_resource resource{ initialBlockSize, &upstream };
+		std::pmr::vector<Destructor> destructors{ &resource };
+		std::vector<std::shared_ptr<const void>> adopted;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,270 @@
+#pragma once
+
+#include "Ini.h"
+#include "IniError.h"
+#include "IniMappedFile.h"
+#include "IniParserApi.h"
+
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace inip
+{
+	// Compiled settings
+
+	// Binary form of parsed settings, loaded without running the scanner or the parser.
+	// Layout, every section starts at an 8 byte boundary and numbers are stored in the host's byte order:
+	//     header | group slots | groups | option slots | options | string table
+	// Groups and options keep their file order and carry their 'HashKey' hash.
+	// The slot arrays are prebuilt open addressing tables, one over the groups and one per group over its options,
+	// so lookups probe the file as it is and a load only checks the header.
+	// Names and values are stored once in the string table, INTEGER and FLOAT values in binary as well.
+	// LIST values are only stored as their text, elements aren't compiled.
+
+	// Bumped whenever the layout changes, files of another version are rejected
+	constexpr std::uint32_t iniCompiledVersion{ 1 };
+
+	INI_PARSER_API std::string CompileSettings(const IniSettings& iniSettings);
+	INI_PARSER_API void WriteCompiledSettings(const IniSettings& iniSettings, const std::filesystem::path& filePath);
+
+	class IniCompiledFormatError : public std::runtime_error
+	{
+	public:
+
+		INI_PARSER_API IniCompiledFormatError(const std::string& reason);
+
+		INI_PARSER_NODISCARD INI_PARSER_API char const* what() const noexcept override;
+
+	private:
+
+		void SetupErrorMessage(const std::string& reason);
+
+		std::string message;
+	};
+
+	class IniCompiledSettings;
+	class IniCompiledGroup;
+
+	// Views into a loaded compiled file, they're valid as long as the 'IniCompiledSettings' are.
+	// A default constructed view, or one returned for a missing name, is empty and converts to false.
+
+	class IniCompiledOption
+	{
+	public:
+
+		explicit operator bool() const
+		{
+			return optionType != IniOptionType::UNIDENTIFIED;
+		}
+
+		std::string_view GetKey() const
+		{
+			return key;
+		}
+		IniOptionType GetOptionType() const
+		{
+			return optionType;
+		}
+
+		// Same conversions as 'IniOption::TryGetValue'
+
+		template <
+			typename T,
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+		IniResult<T> TryGetValue() const noexcept
+		{
+			if (optionType == IniOptionType::INTEGER)
+				return ConvertInteger<T>(integerValue);
+			if (optionType == IniOptionType::FLOAT)
+				return ConvertFloat<T>(floatValue);
+			return ParseNumber<T>(value);
+		}
+
+		template <
+			typename T,
+			std::enable_if_t<std::is_same_v<T, std::string_view>, bool> = true>
+		IniResult<T> TryGetValue() const noexcept
+		{
+			return value;
+		}
+
+	private:
+
+		friend class IniCompiledGroup;
+
+		std::string_view key;
+		std::string_view value;
+
+		long long integerValue{ 0 };
+		double floatValue{ 0.0 };
+
+		IniOptionType optionType{ IniOptionType::UNIDENTIFIED };
+	};
+
+	class IniCompiledGroup
+	{
+	public:
+
+		explicit operator bool() const
+		{
+			return settings != nullptr;
+		}
+
+		INI_PARSER_API std::string_view GetGroupName() const;
+
+		// Options in file order
+		INI_PARSER_API std::size_t GetOptionsCount() const;
+		INI_PARSER_API IniCompiledOption GetOption(std::size_t index) const;
+
+		INI_PARSER_API IniCompiledOption FindOption(std::string_view key) const noexcept;
+		// Skips hashing, the key's hash was computed at compile time
+		INI_PARSER_API IniCompiledOption FindOption(const IniKey& key) const noexcept;
+
+		template <typename T>
+		IniResult<T> TryGetOptionValue(std::string_view key) const noexcept
+		{
+			IniCompiledOption option = FindOption(key);
+			if (!option)
+				return IniErrorCode::OPTION_NOT_FOUND;
+			return option.TryGetValue<T>();
+		}
+		template <typename T>
+		IniResult<T> TryGetOptionValue(const IniKey& key) const noexcept
+		{
+			IniCompiledOption option = FindOption(key);
+			if (!option)
+				return IniErrorCode::OPTION_NOT_FOUND;
+			return option.TryGetValue<T>();
+		}
+
+	private:
+
+		friend class IniCompiledSettings;
+
+		IniCompiledOption FindOption(std::string_view key, std::uint64_t hash) const noexcept;
+
+		const IniCompiledSettings* settings{ nullptr };
+		std::uint32_t group{ 0 };
+	};
+
+	// A compiled file memory mapped for reading.
+	// Opening it checks the header and the bounds of the sections only, the entries are checked as they're read,
+	// and a corrupted entry reads as a missing one. The checksum of the whole file is verified on request.
+
+	class IniCompiledSettings
+	{
+	public:
+
+		INI_PARSER_API IniCompiledSettings() = default;
+		INI_PARSER_API explicit IniCompiledSettings(const std::filesystem::path& filePath, bool verifyChecksum = false);
+
+		// Views point into the file's contents, so the settings stay where they are
+		IniCompiledSettings(const IniCompiledSettings&) = delete;
+		IniCompiledSettings& operator=(const IniCompiledSettings&) = delete;
+
+		INI_PARSER_API void Open(const std::filesystem::path& filePath, bool verifyChecksum = false);
+		// The buffer is owned by the caller and must outlive the settings
+		INI_PARSER_API void OpenBuffer(std::string_view compiledData, bool verifyChecksum = false);
+
+		INI_PARSER_API bool VerifyChecksum() const;
+
+		INI_PARSER_API std::string_view GetIniSettingsName() const;
+
+		// Groups in file order
+		INI_PARSER_API std::size_t GetGroupsCount() const;
+		INI_PARSER_API IniCompiledGroup GetGroup(std::size_t index) const;
+
+		INI_PARSER_API IniCompiledGroup FindGroup(std::string_view groupName) const noexcept;
+		// Skips hashing, the name's hash was computed at compile time
+		INI_PARSER_API IniCompiledGroup FindGroup(const IniKey& groupName) const noexcept;
+
+		template <typename T>
+		IniResult<T> TryGetOptionValue(std::string_view groupName, std::string_view key) const noexcept
+		{
+			IniCompiledGroup group = FindGroup(groupName);
+			if (!group)
+				return IniErrorCode::GROUP_NOT_FOUND;
+			return group.TryGetOptionValue<T>(key);
+		}
+		template <typename T>
+		IniResult<T> TryGetOptionValue(const IniKey& groupName, const IniKey& key) const noexcept
+		{
+			IniCompiledGroup group = FindGroup(groupName);
+			if (!group)
+				return IniErrorCode::GROUP_NOT_FOUND;
+			return group.TryGetOptionValue<T>(key);
+		}
+
+	private:
+
+		friend class IniCompiledGroup;
+
+		struct Header
+		{
+			char magic[8];
+			std::uint32_t version;
+			std::uint32_t byteOrder;
+			std::uint64_t fileSize;
+			std::uint64_t checksum;
+
+			std::uint32_t nameOffset;
+			std::uint32_t nameSize;
+
+			std::uint32_t groupsCount;
+			std::uint32_t groupSlotsCount;
+			std::uint32_t optionsCount;
+			std::uint32_t optionSlotsCount;
+
+			std::uint64_t groupSlotsOffset;
+			std::uint64_t groupsOffset;
+			std::uint64_t optionSlotsOffset;
+			std::uint64_t optionsOffset;
+			std::uint64_t stringsOffset;
+			std::uint64_t stringsSize;
+		};
+
+		struct GroupRecord
+		{
+			std::uint64_t hash;
+			std::uint32_t nameOffset;
+			std::uint32_t nameSize;
+			std::uint32_t firstOption;
+			std::uint32_t optionsCount;
+			std::uint32_t firstSlot;
+			std::uint32_t slotsCount;
+		};
+
+		struct OptionRecord
+		{
+			std::uint64_t hash;
+			std::uint32_t keyOffset;
+			std::uint32_t keySize;
+			std::uint32_t valueOffset;
+			std::uint32_t valueSize;
+			std::uint32_t optionType;
+			std::uint32_t padding;
+			// 'long long' or 'double' bits, depending on the type
+			std::uint64_t numericValue;
+		};
+
+		friend std::string CompileSettings(const IniSettings& iniSettings);
+
+		void Validate(bool verifyChecksum);
+
+		IniCompiledGroup FindGroup(std::string_view groupName, std::uint64_t hash) const noexcept;
+
+		bool ReadGroup(std::uint32_t index, GroupRecord& record) const noexcept;
+		bool ReadOption(std::uint32_t index, OptionRecord& record) const noexcept;
+		std::uint32_t ReadSlot(std::uint64_t slotsOffset, std::uint32_t slot) const noexcept;
+		std::string_view ReadString(std::uint32_t offset, std::uint32_t size) const noexcept;
+
+		IniMappedFile compiledFile;
+		std::string_view compiledData;
+
+		Header header{};
+	};
+}
\ No newline at end of file
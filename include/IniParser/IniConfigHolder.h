@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Ini.h"
+#include "IniParserApi.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace inip
+{
+	// Keeps the latest settings of a file and reloads them when the file changes.
+	// Every reload builds a brand new IniSettings in the background and publishes it as an immutable snapshot,
+	// readers never see a settings tree that's being built. A snapshot is freed once the last reader lets go of it.
+	// A reload that fails keeps the previous snapshot.
+	// Snapshots are shared between threads, they must not be modified.
+
+	class IniConfigHolder
+	{
+	public:
+
+		// Called after every reload attempt, on the thread that did it, without holding any of the holder's locks.
+		// 'error' is null when the new snapshot was published.
+		// A callback run by the watcher may call 'Reload', 'SetReloadCallback' and 'StopWatching', but not 'StartWatching'.
+		using ReloadCallback = std::function<void(std::shared_ptr<const IniSettings> snapshot, std::exception_ptr error)>;
+
+		// Per-thread cache of the latest snapshot.
+		// 'Get' costs a single atomic load as long as no new snapshot was published.
+		class Reader
+		{
+		public:
+
+			INI_PARSER_API explicit Reader(const IniConfigHolder& configHolder);
+
+			INI_PARSER_API const IniSettings& Get();
+
+		private:
+
+			const IniConfigHolder* configHolder{ nullptr };
+
+			std::shared_ptr<const IniSettings> snapshot;
+			std::uint64_t generation{ 0 };
+		};
+
+		// Loads the file right away, a failure to do so is thrown
+		INI_PARSER_API explicit IniConfigHolder(const std::filesystem::path& iniFilePath);
+		INI_PARSER_API ~IniConfigHolder();
+
+		IniConfigHolder(const IniConfigHolder&) = delete;
+		IniConfigHolder& operator=(const IniConfigHolder&) = delete;
+
+		INI_PARSER_API std::shared_ptr<const IniSettings> GetSnapshot() const;
+		// Bumped every time a snapshot is published
+		INI_PARSER_API std::uint64_t GetGeneration() const;
+
+		// Parses the file again and publishes the result, returns false (and keeps the old snapshot) on failure
+		INI_PARSER_API bool Reload();
+
+		INI_PARSER_API void SetReloadCallback(ReloadCallback reloadCallback);
+
+		// Starts a background thread that reloads the file whenever it's written or replaced.
+		// On Linux changes are reported by inotify, elsewhere (or if inotify can't watch the file's directory)
+		// the file's write time is polled every 'pollInterval'.
+		INI_PARSER_API void StartWatching(std::chrono::milliseconds pollInterval = std::chrono::milliseconds{ 500 });
+		INI_PARSER_API void StopWatching();
+
+	private:
+
+		std::shared_ptr<const IniSettings> LoadSnapshot() const;
+		void Publish(std::shared_ptr<const IniSettings> snapshot);
+
+		void Watch(std::chrono::milliseconds pollInterval);
+		// Returns false if notifications can't be set up or fail before the watcher is stopped
+		bool WatchNotifications();
+		void WatchWriteTime(std::chrono::milliseconds pollInterval);
+
+		std::filesystem::path iniFilePath;
+
+		mutable std::mutex snapshotMutex;
+		std::shared_ptr<const IniSettings> snapshot;
+		std::atomic<std::uint64_t> generation{ 0 };
+
+		std::mutex reloadMutex;
+		ReloadCallback reloadCallback;
+
+		std::thread watcher;
+		std::mutex watcherMutex;
+		std::condition_variable watcherStopped;
+		bool stopWatching{ false };
+		// Self-pipe that wakes the inotify watcher up when it has to stop
+		int stopPipe[2]{ -1, -1 };
+	};
+}
\ No newline at end of file
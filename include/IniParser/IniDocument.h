@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Ini.h"
+#include "IniParserApi.h"
+#include "IniWriter.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inip
+{
+	// Lossless form of a source that supports in-place edits.
+	// The document keeps the source text as it is, trivia (whitespace, comments) included,
+	// along with the byte spans of every group header and every option's key and value.
+	// An edit splices the bytes of a single value, everything around it is kept byte for byte,
+	// and the spans that follow are shifted. New text is formatted the way 'IniWriter' formats it.
+	// Like the settings, the first group with a given name and the first option with a given key win.
+
+	class IniDocument
+	{
+	public:
+
+		INI_PARSER_API IniDocument() = default;
+		// Throws the scanner's and the parser's errors for a malformed source
+		INI_PARSER_API explicit IniDocument(std::string iniSource);
+
+		INI_PARSER_API void Open(const std::filesystem::path& iniFilePath);
+		INI_PARSER_API void Load(std::string iniSource);
+
+		INI_PARSER_API const std::string& GetSource() const;
+
+		INI_PARSER_API bool GroupExists(std::string_view groupName) const;
+		INI_PARSER_API bool OptionExists(std::string_view groupName, std::string_view key) const;
+
+		// The value as written in the source, quotes included. Empty if there's no such option.
+		INI_PARSER_API std::string_view GetValueText(std::string_view groupName, std::string_view key) const;
+
+		// Replace the value of an existing option, return false if there's none
+		INI_PARSER_API bool SetValue(std::string_view groupName, std::string_view key, std::string_view value);
+		template <
+			typename T,
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+		bool SetValue(std::string_view groupName, std::string_view key, const T& value)
+		{
+			return SetValueText(groupName, key, IniWriter::FormatNumberValue(value));
+		}
+
+		// Add an option after the last option of the group, or set it if it exists.
+		// A missing group is added at the end of the source.
+		INI_PARSER_API void InsertOption(std::string_view groupName, std::string_view key, std::string_view value);
+		template <
+			typename T,
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+		void InsertOption(std::string_view groupName, std::string_view key, const T& value)
+		{
+			InsertOptionText(groupName, key, IniWriter::FormatNumberValue(value));
+		}
+
+		// Writes the whole source
+		INI_PARSER_API void Save(const std::filesystem::path& iniFilePath);
+		// Rewrites the file from the first byte edited since the document was loaded or saved.
+		// The file must hold what the document held at that point, e.g. the file it was opened from.
+		INI_PARSER_API void SaveInPlace(const std::filesystem::path& iniFilePath);
+
+	private:
+
+		struct OptionNode
+		{
+			std::size_t keyBegin{ 0 };
+			std::size_t valueBegin{ 0 };
+			std::size_t valueEnd{ 0 };
+		};
+
+		struct GroupNode
+		{
+			std::size_t headerBegin{ 0 };
+			std::size_t headerEnd{ 0 };
+
+			std::vector<OptionNode> options;
+			// Index in 'options', the first option with a key wins
+			std::map<std::string, std::size_t, std::less<>> optionsByKey;
+		};
+
+		INI_PARSER_API bool SetValueText(std::string_view groupName, std::string_view key, const std::string& valueText);
+		INI_PARSER_API void InsertOptionText(std::string_view groupName, std::string_view key, const std::string& valueText);
+
+		const OptionNode* FindOption(std::string_view groupName, std::string_view key) const;
+
+		// Replaces the bytes in [begin, end) and moves every span that follows them
+		void Splice(std::size_t begin, std::size_t end, std::string_view text);
+		void ShiftSpans(std::size_t begin, std::size_t end, std::ptrdiff_t delta);
+
+		std::string iniSource;
+
+		// File order
+		std::vector<GroupNode> groups;
+		std::map<std::string, std::size_t, std::less<>> groupsByName;
+
+		// First byte changed since the source was loaded or saved
+		std::size_t dirtyBegin{ std::string::npos };
+	};
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 // [GROUP]
 // "key = value"
@@ -19,7 +20,7 @@ namespace inip
 			const std::string& value,
 			const std::string& castType);
 
-		INI_PARSER_API _NODISCARD char const* what() const override;
+		INI_PARSER_NODISCARD INI_PARSER_API char const* what() const noexcept override;
 
 	private:
 
@@ -37,7 +38,7 @@ namespace inip
 
 		INI_PARSER_API IniSettingOptionNotFoundError(const std::string& key);
 
-		INI_PARSER_API _NODISCARD char const* what() const override;
+		INI_PARSER_NODISCARD INI_PARSER_API char const* what() const noexcept override;
 
 	private:
 
@@ -45,4 +46,57 @@ namespace inip
 
 		std::string message;
 	};
+
+	// Non-throwing lookups
+
+	enum class IniErrorCode
+	{
+		NONE,
+
+		GROUP_NOT_FOUND,
+		OPTION_NOT_FOUND,
+		VALUE_CAST_ERROR,
+	};
+
+	INI_PARSER_API std::string_view IniErrorCodeToString(IniErrorCode errorCode);
+
+	// Either a value or the reason there's none, returned by the 'TryGet*' family
+	template <typename T>
+	class IniResult
+	{
+	public:
+
+		IniResult(const T& value)
+			: value(value) {}
+		IniResult(IniErrorCode errorCode)
+			: errorCode(errorCode) {}
+
+		bool HasValue() const
+		{
+			return errorCode == IniErrorCode::NONE;
+		}
+		explicit operator bool() const
+		{
+			return HasValue();
+		}
+
+		const T& GetValue() const
+		{
+			return value;
+		}
+		T GetValueOr(const T& defaultValue) const
+		{
+			return HasValue() ? value : defaultValue;
+		}
+
+		IniErrorCode GetErrorCode() const
+		{
+			return errorCode;
+		}
+
+	private:
+
+		T value{};
+		IniErrorCode errorCode{ IniErrorCode::NONE };
+	};
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Ini.h"
+
+#include <string_view>
+
+namespace inip
+{
+	// Receives the contents of a source as it's parsed, no settings are built.
+	// Names and values are views into the source, they're valid until the parse returns.
+	// Values are passed as text (STRING values without their quotes) along with the type the parser deduced,
+	// numbers aren't converted, so their range isn't checked either.
+	// A LIST value is the source text from its first element to its last one, quotes and separators included.
+	// Returning false from any callback stops the parse.
+
+	class IniEventHandler
+	{
+	public:
+
+		virtual ~IniEventHandler() = default;
+
+		virtual bool OnGroupBegin(std::string_view /*groupName*/, int /*line*/)
+		{
+			return true;
+		}
+		virtual bool OnOption(std::string_view /*key*/, std::string_view /*value*/, IniOptionType /*optionType*/, int /*line*/)
+		{
+			return true;
+		}
+		virtual bool OnGroupEnd(std::string_view /*groupName*/)
+		{
+			return true;
+		}
+	};
+}
\ No newline at end of file
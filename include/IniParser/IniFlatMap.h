@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace inip
+{
+	// FNV-1a, it's 'constexpr' and gives the same value on every platform and run
+	constexpr std::uint64_t HashKey(std::string_view key)
+	{
+		std::uint64_t hash{ 14695981039346656037ull };
+		for (char c : key)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Insertion ordered map from a string key to a non-owning pointer.
+	// Entries (cached hash, key view, pointer) are stored contiguously in insertion order,
+	// they're indexed by an open addressing table with linear probing.
+	// A probe compares the high half of the hash stored in the slot itself,
+	// so only a likely match touches the entry, and the key is compared last.
+	// Keys are views, they must stay valid as long as the map does.
+
+	template <typename T>
+	class IniFlatMap
+	{
+	public:
+
+		struct Entry
+		{
+			std::uint64_t hash;
+			std::string_view key;
+			T* value;
+		};
+
+		explicit IniFlatMap(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+			: entries(resource), slots(resource) {}
+
+		// Returns false and keeps the existing entry if the key is already in the map
+		bool Insert(std::string_view key, T* value)
+		{
+			return Insert(key, HashKey(key), value);
+		}
+		bool Insert(std::string_view key, std::uint64_t hash, T* value)
+		{
+			if (Find(key, hash))
+				return false;
+
+			entries.push_back({ hash, key, value });
+			if (entries.size() * 2 > slots.size())
+				Rehash(slots.empty() ? minSlotsCount : slots.size() * 2);
+			else
+				Place(hash, static_cast<std::uint32_t>(entries.size()));
+			return true;
+		}
+
+		T* Find(std::string_view key) const
+		{
+			return Find(key, HashKey(key));
+		}
+		T* Find(std::string_view key, std::uint64_t hash) const
+		{
+			if (slots.empty())
+				return nullptr;
+
+			std::size_t mask = slots.size() - 1;
+			std::uint32_t tag = static_cast<std::uint32_t>(hash >> 32);
+			for (std::size_t slot = hash & mask; ; slot = (slot + 1) & mask)
+			{
+				const Slot& probe = slots[slot];
+				if (probe.entry == 0)
+					return nullptr;
+				if (probe.tag == tag)
+				{
+					const Entry& entry = entries[probe.entry - 1];
+					// Interned keys share their text, so they're equal if their addresses are
+					if (entry.hash == hash && entry.key.size() == key.size() &&
+						(entry.key.data() == key.data() || entry.key == key))
+					{
+						return entry.value;
+					}
+				}
+			}
+		}
+
+		std::size_t Size() const
+		{
+			return entries.size();
+		}
+
+		typename std::pmr::vector<Entry>::const_iterator begin() const
+		{
+			return entries.begin();
+		}
+		typename std::pmr::vector<Entry>::const_iterator end() const
+		{
+			return entries.end();
+		}
+
+	private:
+
+		struct Slot
+		{
+			std::uint32_t tag;
+			// Index of the entry + 1, 0 marks an empty slot
+			std::uint32_t entry;
+		};
+
+		static constexpr std::size_t minSlotsCount{ 8 };
+
+		void Rehash(std::size_t slotsCount)
+		{
+			slots.assign(slotsCount, Slot{ 0, 0 });
+			for (std::size_t entry = 0; entry < entries.size(); entry++)
+			{
+				Place(entries[entry].hash, static_cast<std::uint32_t>(entry + 1));
+			}
+		}
+		void Place(std::uint64_t hash, std::uint32_t entry)
+		{
+			std::size_t mask = slots.size() - 1;
+			std::size_t slot = hash & mask;
+			while (slots[slot].entry != 0)
+			{
+				slot = (slot + 1) & mask;
+			}
+			slots[slot] = Slot{ static_cast<std::uint32_t>(hash >> 32), entry };
+		}
+
+		std::pmr::vector<Entry> entries;
+		std::pmr::vector<Slot> slots;
+	};
+}
\ No newline at end of file
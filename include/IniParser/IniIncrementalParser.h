@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Ini.h"
+#include "IniParserApi.h"
+#include "IniScanner.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inip
+{
+	// Change set
+
+	enum class IniChangeType
+	{
+		ADDED,
+		REMOVED,
+		MODIFIED,
+	};
+
+	struct IniOptionChange
+	{
+		IniChangeType changeType{ IniChangeType::MODIFIED };
+
+		std::string key;
+
+		// Empty when the option was added
+		std::string oldValue;
+		// Empty when the option was removed
+		std::string newValue;
+	};
+
+	struct IniGroupChange
+	{
+		IniChangeType changeType{ IniChangeType::MODIFIED };
+
+		std::string groupName;
+
+		// Filled for MODIFIED groups only, in file order
+		std::vector<IniOptionChange> optionChanges;
+	};
+
+	struct IniChangeSet
+	{
+		// Added and modified groups in the order of the new source, followed by the removed ones
+		std::vector<IniGroupChange> groupChanges;
+
+		bool Empty() const
+		{
+			return groupChanges.empty();
+		}
+	};
+
+	INI_PARSER_API std::string IniChangeTypeToString(IniChangeType changeType);
+
+	// Incremental Parser
+
+	// Keeps the previous source and parse result between updates.
+	// The source is split at group headers, and only the groups whose text changed are scanned and parsed again,
+	// the groups of unchanged text are shared with the previous settings instead of being rebuilt.
+	// Since groups are shared between consecutive results, settings returned by 'GetIniSettings' must not be modified.
+
+	class IniIncrementalParser
+	{
+	public:
+
+		INI_PARSER_API explicit IniIncrementalParser(const std::string& iniSettingsName);
+
+		// The first update parses the whole source and reports every group as added.
+		// If the new source fails to parse, the error is thrown and the previous state is kept.
+		INI_PARSER_API IniChangeSet Update(std::string iniSource);
+		INI_PARSER_API IniChangeSet Update(const std::filesystem::path& iniFilePath);
+
+		INI_PARSER_API std::shared_ptr<IniSettings> GetIniSettings() const;
+
+	private:
+
+		// The text of one group, from its header up to the next one
+		struct Chunk
+		{
+			std::string_view text;
+			std::uint64_t hash{ 0 };
+			std::shared_ptr<IniSettings> chunkSettings;
+		};
+
+		std::shared_ptr<IniSettings> ParseChunk(std::string_view chunkText, int firstLine) const;
+
+		static void DiffGroups(
+			const IniSettings* oldSettings, const IniSettings& newSettings,
+			const std::vector<std::string_view>& groupNames,
+			IniChangeSet& changeSet);
+		static void DiffOptions(const IniGroup& oldGroup, const IniGroup& newGroup, IniGroupChange& groupChange);
+
+		std::string iniSettingsName;
+
+		// The chunks' text points into 'iniSource'
+		std::string iniSource;
+		std::vector<Chunk> chunks;
+
+		std::shared_ptr<IniSettings> iniSettings;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Ini.h"
+#include "IniParser.h"
+#include "IniParserApi.h"
+
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inip
+{
+	// Outcome of loading one file, either the settings or the error that stopped it
+	struct IniLoadResult
+	{
+		std::filesystem::path iniFilePath;
+
+		std::shared_ptr<IniSettings> iniSettings;
+
+		std::exception_ptr error;
+		std::string errMsg;
+	};
+
+	// Loads many files concurrently on a bounded pool of threads.
+	// Every file gets its own parser, a file that fails to load doesn't affect the others.
+	// Results come back in the order of the input paths.
+
+	class IniLoader
+	{
+	public:
+
+		// Threads used to load files, 0 means one per hardware thread
+		INI_PARSER_API void SetThreadsCount(unsigned threadsCount);
+		INI_PARSER_API unsigned GetThreadsCount() const;
+
+		INI_PARSER_API void SetParseMode(IniParseMode parseMode);
+		INI_PARSER_API IniParseMode GetParseMode() const;
+
+		INI_PARSER_API std::vector<IniLoadResult> Load(const std::vector<std::filesystem::path>& iniFilePaths) const;
+
+		// Loads the regular files of 'directory' whose names match 'pattern' ('*' and '?' wildcards),
+		// ordered by path
+		INI_PARSER_API std::vector<IniLoadResult> LoadDirectory(
+			const std::filesystem::path& directory,
+			std::string_view pattern = "*.ini",
+			bool recursive = false) const;
+
+	private:
+
+		IniLoadResult LoadFile(const std::filesystem::path& iniFilePath) const;
+
+		unsigned threadsCount{ 0 };
+		IniParseMode parseMode{ IniParseMode::STREAMING };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "IniParserApi.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace inip
+{
+	// Read-only view of a file's contents.
+	// On POSIX systems the file is memory mapped, so the scanner works directly on the mapped pages.
+	// Elsewhere, or when mapping fails (pipes, special files), the contents are read into memory once.
+
+	class IniMappedFile
+	{
+	public:
+
+		INI_PARSER_API IniMappedFile() = default;
+		INI_PARSER_API explicit IniMappedFile(const std::filesystem::path& filePath);
+		INI_PARSER_API ~IniMappedFile();
+
+		INI_PARSER_API IniMappedFile(IniMappedFile&& other) noexcept;
+		INI_PARSER_API IniMappedFile& operator=(IniMappedFile&& other) noexcept;
+
+		IniMappedFile(const IniMappedFile&) = delete;
+		IniMappedFile& operator=(const IniMappedFile&) = delete;
+
+		INI_PARSER_API void Open(const std::filesystem::path& filePath);
+		INI_PARSER_API void Close();
+
+		INI_PARSER_API std::string_view GetContents() const;
+		INI_PARSER_API bool IsMapped() const;
+
+	private:
+
+		bool Map(const std::filesystem::path& filePath);
+		void Read(const std::filesystem::path& filePath);
+
+		const char* mappedData{ nullptr };
+		std::size_t mappedSize{ 0 };
+
+		std::string readContents;
+	};
+}
\ No newline at end of file
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "Ini.h"
+#include "IniEventHandler.h"
 #include "IniParserApi.h"
 #include "IniScanner.h"
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <filesystem>
+#include <functional>
+#include <istream>
 #include <memory>
 
 namespace inip
@@ -17,54 +23,215 @@ namespace inip
 
 		INI_PARSER_API IniParserError(const Token& errorToken, std::string_view errMsg);
 
-		INI_PARSER_API _NODISCARD const char* what() const override;
+		INI_PARSER_NODISCARD INI_PARSER_API const char* what() const noexcept override;
 
 	private:
 
-		void CreateErrorMessage(std::string_view errMsg);
+		void CreateErrorMessage(const Token& errorToken, std::string_view errMsg);
 
-		Token errorToken;
 		std::string errMsg;
 	};
 
 	// Ini Parser
 
+	enum class IniParseMode
+	{
+		// Scan the whole source into a token vector first, then parse it
+		TWO_PHASE,
+		// Pull tokens from the scanner on demand through a small lookahead window
+		STREAMING,
+		// Split the source at group headers and parse the chunks on a pool of threads.
+		// Small sources, or ones with a single group, are parsed in STREAMING mode.
+		PARALLEL,
+		// Only find where the groups begin and read their names, a group is parsed the first time it's looked up.
+		// The settings keep the source (a file stays mapped, a buffer is copied),
+		// and errors inside a group are reported when it's built (see 'IniSettings::GetGroup').
+		LAZY,
+	};
+
+	// Instrumentation of a single parse, filled by 'IniParser::Parse' when it's given one.
+	// Nothing is measured or counted when it isn't.
+	// In the STREAMING and PARALLEL modes scanning is interleaved with parsing and is part of 'parseTime',
+	// the PARALLEL mode reports its split into groups as 'scanTime'.
+	// The LAZY mode reports its pre-pass as 'scanTime' and counts the groups it found, their tokens and options aren't read.
+
+	struct IniParseStats
+	{
+		std::size_t bytesRead{ 0 };
+
+		// Opening (mapping or reading) the file, or reading a stream
+		std::chrono::nanoseconds ioTime{ 0 };
+		// The two-phase scan into a token vector
+		std::chrono::nanoseconds scanTime{ 0 };
+		// Parsing and building the settings, they're a single pass
+		std::chrono::nanoseconds parseTime{ 0 };
+		std::chrono::nanoseconds totalTime{ 0 };
+
+		// Indexed by 'TokenType'
+		std::array<std::size_t, tokenTypesCount> tokensCount{};
+
+		// Registered in the settings, duplicates aren't counted
+		std::size_t groupsCount{ 0 };
+		std::size_t optionsCount{ 0 };
+
+		// What the settings' arenas took from the heap
+		std::size_t bytesAllocated{ 0 };
+		std::size_t allocationsCount{ 0 };
+
+		std::size_t GetTokensCount(TokenType tokenType) const
+		{
+			return tokensCount[static_cast<std::size_t>(tokenType)];
+		}
+	};
+
 	class IniParser
 	{
+		// Reparses single groups of a source into settings of their own
+		friend class IniIncrementalParser;
+		// Parses the groups of a LAZY parse on demand
+		friend class IniLazyGroupLoader;
+
 	public:
 
+		static constexpr std::size_t defaultStreamBufferSize{ 64 * 1024 };
+
 		INI_PARSER_API IniParser();
 		INI_PARSER_API ~IniParser();
 
-		INI_PARSER_API void Parse(const std::filesystem::path& iniFilePath);
-		INI_PARSER_API void Parse(const std::string& iniSource, const std::string& iniSettingsName);
+		INI_PARSER_API void SetParseMode(IniParseMode parseMode);
+		INI_PARSER_API IniParseMode GetParseMode() const;
+
+		// Threads used by the PARALLEL mode, 0 means one per hardware thread
+		INI_PARSER_API void SetThreadsCount(unsigned threadsCount);
+		INI_PARSER_API unsigned GetThreadsCount() const;
+
+		// Keys and group names of the settings parsed from now on are interned into 'symbolTable',
+		// settings sharing a table share the text of their names. Null (the default) copies them per settings.
+		INI_PARSER_API void SetSymbolTable(std::shared_ptr<IniSymbolTable> symbolTable);
+		INI_PARSER_API std::shared_ptr<IniSymbolTable> GetSymbolTable() const;
+
+		// The file is memory mapped where possible and scanned in place
+		INI_PARSER_API void Parse(const std::filesystem::path& iniFilePath, IniParseStats* parseStats = nullptr);
+		// The buffer is owned by the caller and must outlive the call, it isn't copied
+		INI_PARSER_API void Parse(
+			std::string_view iniSource,
+			const std::string& iniSettingsName,
+			IniParseStats* parseStats = nullptr);
+
+		// Reads the source through a buffer of 'bufferSize' bytes that's refilled as the source is parsed,
+		// for sources that don't fit into memory or can't be mapped (pipes, sockets).
+		// Memory use doesn't depend on the source's size, the buffer only grows for a single statement
+		// (a group header, an option or a comment) bigger than it. The parse mode doesn't apply.
+		INI_PARSER_API void ParseStream(
+			std::istream& iniStream,
+			const std::string& iniSettingsName,
+			std::size_t bufferSize = defaultStreamBufferSize,
+			IniParseStats* parseStats = nullptr);
+		// Reads 'fileDescriptor' to its end without closing it (a CRT file descriptor on Windows)
+		INI_PARSER_API void ParseDescriptor(
+			int fileDescriptor,
+			const std::string& iniSettingsName,
+			std::size_t bufferSize = defaultStreamBufferSize,
+			IniParseStats* parseStats = nullptr);
+
+		// Reports the groups and options to 'eventHandler' instead of building settings.
+		// The source is always streamed, so memory use doesn't depend on its size, whatever the parse mode.
+		// Returns false if a callback stopped the parse.
+		INI_PARSER_API bool ParseFileEvents(const std::filesystem::path& iniFilePath, IniEventHandler& eventHandler);
+		INI_PARSER_API bool ParseEvents(std::string_view iniSource, IniEventHandler& eventHandler);
 
 		INI_PARSER_API std::shared_ptr<IniSettings> GetIniSettings() const;
 
 	private:
 
-		void InitializeIniParser();
-
-		std::string GetIniFileSrc(const std::filesystem::path& iniFilePath) const;
+		// Reads up to 'size' bytes into 'buffer', returns 0 at the end of the source
+		using ReadFunction = std::function<std::size_t(char* buffer, std::size_t size)>;
 
-		std::shared_ptr<IniGroup> Group();
-		std::string GroupId();
-		std::shared_ptr<IniOption> Option();
+		void InitializeIniParser();
 
-		Token Advance();
-		Token Peek() const;
-		Token Previous() const;
-		Token Consume(TokenType type, std::string_view errMsg);
+		// Empty settings using the parser's symbol table
+		std::shared_ptr<IniSettings> CreateSettings(const std::string& iniSettingsName) const;
+
+		void BeginParse(const std::string& iniSettingsName, IniParseStats* parseStats);
+		// 'countGroups' is false when visiting the groups would build them (LAZY)
+		void EndParse(std::chrono::steady_clock::time_point begin, bool countGroups);
+
+		// 'sourceOwner' keeps 'iniSource' alive, a LAZY parse copies the source if it's null
+		void ParseBuffer(
+			std::string_view iniSource,
+			const std::string& iniSettingsName,
+			IniParseStats* parseStats,
+			std::shared_ptr<const void> sourceOwner);
+
+		void ParseSource(std::string_view iniSource, int firstLine, bool streaming);
+		void ParseParallel(std::string_view iniSource);
+		void ParseLazy(std::string_view iniSource, std::shared_ptr<const void> sourceOwner);
+		void ParseChunked(const ReadFunction& read, std::size_t bufferSize);
+
+		// Parses whole statements, options at the beginning belong to the group of an earlier chunk
+		void ParseStatements();
+		// Index of the last token a statement begins at, 0 if there's a single statement or none
+		std::size_t LastStatementBegin() const;
+
+		// Reads the header 'iniSource' begins with, returns false if there's none (only comments are left)
+		bool ScanGroupHeader(std::string_view iniSource, int firstLine, std::string_view& groupName);
+
+		IniGroup& Group();
+		std::string_view GroupId();
+		void Option(IniGroup& iniGroup);
+		void CreateOption(IniGroup& iniGroup, const Token& optionKey, const Token& value);
+		void CreateListOption(IniGroup& iniGroup, std::string_view optionKey, const Token& firstValue);
+		// Collects the elements of a list into 'listElements', "value (',' value)*"
+		void ListElements(const Token& firstValue);
+		// Index of the first numeric element of 'listElements' that doesn't fit into its type
+		std::size_t FailingListElement() const;
+
+		bool GroupEvents(IniEventHandler& eventHandler);
+		bool OptionEvent(IniEventHandler& eventHandler);
+
+		// The text a value token stands for, and the type of option it makes
+		IniOptionType OptionValue(const Token& value, std::string_view& valueText) const;
+
+		const Token& Advance();
+		const Token& Peek() const;
+		const Token& Previous() const;
+		const Token& Consume(TokenType type, std::string_view errMsg);
+
+		void CountToken(const Token& token);
+		void CountSettings(bool countGroups);
 
 		bool Check(TokenType type);
 		bool AtEnd() const;
 
+		const Token& TokenAt(int index) const;
+
 		void Clear();
 
+		// An option rule ("key = value") keeps its key token while advancing
+		// three more times, so the streaming window must hold at least four tokens.
+		// A list option copies its key's literal first, so its elements can advance any further.
+		static constexpr int lookaheadSize{ 4 };
+
 		std::unique_ptr<IniScanner> iniScanner;
+		// Two-phase token vector, null while tokens are streamed through 'lookahead'
 		std::vector<Token>* tokens{ nullptr };
+		Token lookahead[lookaheadSize]{};
 
 		std::shared_ptr<IniSettings> iniSettings;
+		std::shared_ptr<IniSymbolTable> symbolTable;
+		// The group options are added to while a source is parsed in chunks
+		IniGroup* currentGroup{ nullptr };
+
+		// Reused by every list option, so collecting the elements doesn't allocate once it's grown
+		std::vector<IniListElement> listElements;
+		// Tokens of the elements, errors are reported at the element that caused them
+		std::vector<Token> listTokens;
+
+		// Null unless the current parse is instrumented
+		IniParseStats* parseStats{ nullptr };
+
+		IniParseMode parseMode{ IniParseMode::TWO_PHASE };
+		unsigned threadsCount{ 0 };
 
 		int current{ 0 };
 	};
@@ -1,7 +1,21 @@
 #pragma once
 
 #if defined(INI_PARSER_API_EXPORT)
+#if defined(_MSC_VER)
 #define INI_PARSER_API __declspec(dllexport)
+#else
+#define INI_PARSER_API __attribute__((visibility("default")))
+#endif
 #elif defined(INI_PARSER_API_IMPORT)
+#if defined(_MSC_VER)
 #define INI_PARSER_API __declspec(dllimport)
-#endif
\ No newline at end of file
+#else
+#define INI_PARSER_API
+#endif
+#else
+// Static library, or sources compiled into the application
+#define INI_PARSER_API
+#endif
+
+// Standard replacement for MSVC's '_NODISCARD'
+#define INI_PARSER_NODISCARD [[nodiscard]]
\ No newline at end of file
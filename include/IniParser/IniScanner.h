@@ -1,7 +1,9 @@
 #pragma once
 
 #include "IniParserApi.h"
+#include "IniStructuralIndex.h"
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -13,23 +15,36 @@ namespace inip
 	{
 		LEFT_SQUARE_BRACKET, RIGHT_SQUARE_BRACKET,
 
-		EQUAL,
+		EQUAL, COMMA,
 
 		IDENTIFIER, STRING, INTEGER, FLOAT,
 
 		END_OF_FILE,
 	};
 
+	constexpr std::size_t tokenTypesCount{ static_cast<std::size_t>(TokenType::END_OF_FILE) + 1 };
+
 	std::string_view TokenTypeToString(TokenType tokenType);
 
+	// 'literal' and 'value' are views into the scanned source buffer.
+	// The scanner doesn't copy the source, so they stay valid as long as the buffer does.
 	struct Token
 	{
 		TokenType type;
 
 		int line{ 0 };
 
-		std::string literal;
-		std::string value;
+		std::string_view literal;
+		std::string_view value;
+	};
+
+	// Byte range of a source and the line it starts on
+	struct IniSourceSpan
+	{
+		std::size_t begin{ 0 };
+		std::size_t end{ 0 };
+
+		int line{ 0 };
 	};
 
 	class IniScannerError : public std::runtime_error
@@ -38,7 +53,7 @@ namespace inip
 
 		INI_PARSER_API IniScannerError(std::string_view errMsg, int errLine);
 
-		INI_PARSER_API _NODISCARD const char* what() const override;
+		INI_PARSER_NODISCARD INI_PARSER_API const char* what() const noexcept override;
 
 	private:
 
@@ -52,26 +67,49 @@ namespace inip
 	{
 	public:
 
-		void Scan(const std::string& iniSource);
+		// Two-phase mode: tokenizes the whole source into the token vector
+		void Scan(std::string_view iniSource, int firstLine = 0);
+		// Two-phase scan of the beginning of a source whose rest isn't read yet, no END_OF_FILE token is added.
+		// It stops without an error at the first token the prefix may cut short: a string or a comment
+		// the prefix doesn't close, or an error on its last line. Returns where the unscanned rest begins.
+		std::size_t ScanPrefix(std::string_view iniSource, int firstLine = 0);
+
+		// Streaming mode: tokens are pulled one by one with 'NextToken'
+		void Begin(std::string_view iniSource, int firstLine = 0);
+		Token NextToken();
+
+		// Cheap pre-pass that only follows strings and comments to find where groups begin.
+		// Returns one span per group, the first span also covers whatever comes before the first group.
+		static std::vector<IniSourceSpan> SplitAtGroups(std::string_view iniSource);
+
 		void Clear();
 
 		std::vector<Token>* GetTokensPtr();
 
 	private:
 
-		void ScanToken();
+		// Thrown where a prefix ends inside of a token, caught by 'ScanPrefix'
+		struct PrefixEnd
+		{
+		};
+
+		bool ScanToken(Token& token);
 
 		void BeginToken();
-		void AddToken(TokenType type);
+		Token MakeToken(TokenType type);
+		Token MakeEndOfFileToken();
 
 		char Advance();
 		bool Match(char expected);
 		char Peek();
 		char PeekNext();
 
-		void String();
-		void Number();
-		void Identifier();
+		void LineComment();
+		void MultiLineComment();
+
+		Token String();
+		Token Number();
+		Token Identifier();
 
 		bool IsAlpha(char c) const;
 		bool IsDigit(char c) const;
@@ -80,12 +118,18 @@ namespace inip
 
 		bool AtEnd() const;
 
-		std::string iniSource;
+		void SkipToStructural();
+
+		std::string_view iniSource;
+		IniStructuralIndex structuralIndex;
 
-		int current{ 0 };
-		int start{ 0 };
+		std::size_t current{ 0 };
+		std::size_t start{ 0 };
 		int line{ 0 };
 
+		// Set while 'ScanPrefix' runs
+		bool scanningPrefix{ false };
+
 		std::vector<Token> tokens;
 	};
 }
\ No newline at end of file
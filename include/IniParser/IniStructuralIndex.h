@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace inip
+{
+	// Bitmap of the structural characters ('[', ']', '=', '"', '\n', '/', '*') of a source.
+	// The bitmap is built with SIMD instructions (SSE2, or AVX2 when the CPU supports it)
+	// one window at a time, so the scanner can jump over comment and string bodies
+	// instead of visiting every character, while the memory footprint stays constant.
+
+	class IniStructuralIndex
+	{
+	public:
+
+		void Reset(std::string_view source);
+
+		// Returns the position of the first structural character at or after 'position',
+		// or the size of the source if there's none
+		std::size_t NextStructural(std::size_t position);
+
+	private:
+
+		void IndexWindow(std::size_t windowBegin);
+
+		static constexpr std::size_t blockSize{ 64 };
+		static constexpr std::size_t windowBlocks{ 64 };
+
+		std::string_view source;
+
+		std::size_t windowBegin{ 0 };
+		std::size_t windowEnd{ 0 };
+
+		std::uint64_t bits[windowBlocks]{};
+	};
+}
\ No newline at end of file
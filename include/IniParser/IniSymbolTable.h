@@ -0,0 +1,119 @@
+#pragma once
+
+#include "IniFlatMap.h"
+#include "IniParserApi.h"
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory_resource>
+#include <shared_mutex>
+#include <string_view>
+
+namespace inip
+{
+	using IniSymbolId = std::uint32_t;
+
+	// Id of a name that isn't interned
+	constexpr IniSymbolId noSymbol{ std::numeric_limits<IniSymbolId>::max() };
+
+	// Interned name, its text is owned by the symbol table and stays put as long as the table is alive.
+	// Names interned in the same table are equal if and only if their ids are.
+	// A symbol converts to an 'IniKey', so it's looked up with its hash already computed.
+
+	class IniSymbol
+	{
+	public:
+
+		constexpr IniSymbol() = default;
+		constexpr IniSymbol(IniSymbolId id, std::string_view name, std::uint64_t hash)
+			: id(id), name(name), hash(hash) {}
+
+		constexpr IniSymbolId GetId() const
+		{
+			return id;
+		}
+		constexpr std::string_view GetName() const
+		{
+			return name;
+		}
+		constexpr std::uint64_t GetHash() const
+		{
+			return hash;
+		}
+
+	private:
+
+		IniSymbolId id{ noSymbol };
+		std::string_view name;
+		std::uint64_t hash{ 0 };
+	};
+
+	// Symbol table shared by any number of settings (and parses), every distinct name is stored once.
+	// Names are only ever added, a table grows with the number of distinct keys and group names it has seen.
+	// It's safe to use from several threads at once, lookups of names that are already interned take a shared lock.
+
+	class IniSymbolTable
+	{
+	public:
+
+		INI_PARSER_API IniSymbolTable();
+
+		IniSymbolTable(const IniSymbolTable&) = delete;
+		IniSymbolTable& operator=(const IniSymbolTable&) = delete;
+
+		// Returns the symbol of 'name', it's added the first time it's seen
+		INI_PARSER_API IniSymbol Intern(std::string_view name);
+
+		// 'id' must come from this table
+		INI_PARSER_API IniSymbol GetSymbol(IniSymbolId id) const;
+		INI_PARSER_API std::size_t GetSymbolsCount() const;
+
+	private:
+
+		mutable std::shared_mutex mutex;
+
+		// Indexed by id, a deque doesn't move its elements as it grows
+		std::deque<IniSymbol> symbols;
+		IniFlatMap<const IniSymbol> symbolsByName;
+		std::pmr::monotonic_buffer_resource names;
+	};
+
+	// Key of an option or name of a group: either a view of an interned symbol's text,
+	// or a copy of its own allocated from a memory resource (usually the arena of the settings it belongs to).
+	// A copy always owns its text, so it depends neither on the symbol table nor on the arena of the original.
+
+	class IniName
+	{
+	public:
+
+		INI_PARSER_API IniName(std::string_view text, std::pmr::memory_resource* resource);
+		INI_PARSER_API explicit IniName(const IniSymbol& symbol);
+
+		INI_PARSER_API IniName(const IniName& other);
+		INI_PARSER_API IniName(IniName&& other) noexcept;
+		INI_PARSER_API IniName& operator=(const IniName& other);
+		INI_PARSER_API ~IniName();
+
+		std::string_view GetText() const
+		{
+			return std::string_view{ text, size };
+		}
+		// 'noSymbol' unless the name is interned
+		IniSymbolId GetSymbolId() const
+		{
+			return symbolId;
+		}
+
+	private:
+
+		void Release();
+
+		const char* text{ nullptr };
+		std::uint32_t size{ 0 };
+		IniSymbolId symbolId{ noSymbol };
+
+		// Null for an interned name
+		std::pmr::memory_resource* resource{ nullptr };
+	};
+}
\ No newline at end of file
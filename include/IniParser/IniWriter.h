@@ -1,12 +1,142 @@
 #pragma once
 
+#include "Ini.h"
+#include "IniParserApi.h"
+
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
 namespace inip
 {
+	// Writer related errors
+
+	class IniWriterError : public std::runtime_error
+	{
+	public:
+
+		INI_PARSER_API IniWriterError(std::string_view text, std::string_view errMsg);
+
+		INI_PARSER_NODISCARD INI_PARSER_API const char* what() const noexcept override;
+
+	private:
+
+		void CreateErrorMessage(std::string_view text, std::string_view errMsg);
+
+		std::string errMsg;
+	};
+
+	// Ini Writer
+
+	// Serializes settings, or groups and options generated on the fly, in a form the parser reads back.
+	// Text is assembled in a reusable buffer and handed to the output in large blocks,
+	// numbers are formatted with std::to_chars, so writing doesn't allocate once the buffer is reserved.
+	// Groups and options are written in file (insertion) order, the output only depends on the settings.
+	//
+	// Group names are written as identifiers when they are ones and quoted otherwise, keys must be identifiers.
+	// STRING values are always quoted, so they read back as strings. The grammar has no escapes,
+	// a name or a value containing a '"' can't be written and raises an 'IniWriterError'.
+	// Nor does it have signs or exponents: floating point numbers are written in fixed notation, so any finite
+	// non-negative one is a 'digits.digits' literal, negative numbers, 'inf' and 'nan' are written quoted
+	// and read back through 'GetValue<T>'.
+
 	class IniWriter
 	{
 	public:
 
+		static constexpr std::size_t defaultBufferSize{ 64 * 1024 };
+		// Big enough for any double in fixed notation, the largest has 309 digits and the smallest 324 decimals
+		static constexpr std::size_t fixedNumberBufferSize{ 336 };
+
+		INI_PARSER_API explicit IniWriter(std::ostream& outputStream, std::size_t bufferSize = defaultBufferSize);
+		INI_PARSER_API explicit IniWriter(const std::filesystem::path& filePath, std::size_t bufferSize = defaultBufferSize);
+		// Flushes what's left, an error at this point is lost, call 'Flush' to see it
+		INI_PARSER_API ~IniWriter();
+
+		IniWriter(const IniWriter&) = delete;
+		IniWriter& operator=(const IniWriter&) = delete;
+
+		INI_PARSER_API void WriteSettings(const IniSettings& iniSettings);
+		INI_PARSER_API void WriteGroup(const IniGroup& iniGroup);
+
+		// Generation API, options go to the group begun last
+
+		INI_PARSER_API void BeginGroup(std::string_view groupName);
+
+		INI_PARSER_API void WriteOption(const IniOption& iniOption);
+		INI_PARSER_API void WriteOption(std::string_view key, std::string_view value);
+
+		template <
+			typename T,
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+		void WriteOption(std::string_view key, const T& value)
+		{
+			char buffer[fixedNumberBufferSize];
+			char* end = FormatFixed(buffer, value);
+			WriteNumberOption(key, std::string_view{ buffer, static_cast<std::size_t>(end - buffer) }, std::is_floating_point_v<T>);
+		}
+
+		// Hands the buffered text to the output
+		INI_PARSER_API void Flush();
+
+		// Text exactly as the writer would write it, for callers that splice it into existing sources.
+		// They throw an 'IniWriterError' for what can't be written.
+
+		INI_PARSER_API static void CheckKey(std::string_view key);
+		INI_PARSER_API static std::string FormatGroupName(std::string_view groupName);
+		INI_PARSER_API static std::string FormatStringValue(std::string_view value);
+		INI_PARSER_API static std::string FormatNumberValue(std::string_view number, bool floatingPoint);
+		template <
+			typename T,
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+		static std::string FormatNumberValue(const T& value)
+		{
+			char buffer[fixedNumberBufferSize];
+			char* end = FormatFixed(buffer, value);
+			return FormatNumberValue(std::string_view{ buffer, static_cast<std::size_t>(end - buffer) }, std::is_floating_point_v<T>);
+		}
+
+		// Writes 'value' like 'FormatNumber' does, but floating point numbers in fixed notation (as doubles,
+		// which is what options hold). Returns the end of the written characters.
+		template <
+			typename T,
+			std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, bool> = true>
+		static char* FormatFixed(char* buffer, const T& value)
+		{
+			if constexpr (std::is_floating_point_v<T>)
+				return std::to_chars(buffer, buffer + fixedNumberBufferSize, static_cast<double>(value), std::chars_format::fixed).ptr;
+			else
+				return FormatNumber(buffer, value);
+		}
+
 	private:
 
+		INI_PARSER_API void WriteNumberOption(std::string_view key, std::string_view number, bool floatingPoint);
+		void WriteListOption(const IniOption& iniOption);
+
+		void BeginOption(std::string_view key);
+
+		static void CheckString(std::string_view value);
+
+		void AppendName(std::string_view name);
+		void AppendString(std::string_view value);
+		void AppendNumber(std::string_view number, bool floatingPoint);
+		void Append(std::string_view text);
+		void Append(char c);
+
+		void WriteBlock(const char* data, std::size_t size);
+
+		std::ofstream ownedStream;
+		std::ostream* outputStream{ nullptr };
+
+		std::string buffer;
+		std::size_t bufferSize{ defaultBufferSize };
+
+		bool groupBegun{ false };
 	};
 }
\ No newline at end of file
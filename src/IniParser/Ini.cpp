@@ -1,5 +1,7 @@
 #include "../../include/IniParser/Ini.h"
 
+#include <atomic>
+
 namespace inip
 {
 	// Helper functions
@@ -17,76 +19,354 @@ namespace inip
 		case IniOptionType::STRING:
 			return "STRING";
 			break;
+		case IniOptionType::LIST:
+			return "LIST";
+			break;
+		case IniOptionType::UNIDENTIFIED:
+			break;
 		}
 		return "UNIDENTIFIED";
 	}
 
+	// Ini Option
+
+	IniOption::IniOption(
+		std::string_view key,
+		const std::vector<IniListElement>& elements,
+		std::pmr::memory_resource* resource)
+		: key(key, resource), value(resource), optionType(IniOptionType::LIST)
+	{
+		ConvertList(elements);
+	}
+	IniOption::IniOption(
+		const IniSymbol& key,
+		const std::vector<IniListElement>& elements,
+		std::pmr::memory_resource* resource)
+		: key(key), value(resource), optionType(IniOptionType::LIST)
+	{
+		ConvertList(elements);
+	}
+
+	IniOption::IniOption(const IniOption& other)
+		: key(other.key)
+	{
+		CopyFrom(other);
+	}
+	IniOption& IniOption::operator=(const IniOption& other)
+	{
+		if (this != &other)
+		{
+			key = other.key;
+			CopyFrom(other);
+		}
+		return *this;
+	}
+
+	void IniOption::ConvertValue()
+	{
+		const char* first = value.data();
+		const char* last = value.data() + value.size();
+
+		std::from_chars_result result{};
+		if (optionType == IniOptionType::INTEGER)
+			result = std::from_chars(first, last, integerValue);
+		else if (optionType == IniOptionType::FLOAT)
+			result = std::from_chars(first, last, floatValue);
+		else
+			return;
+
+		if (result.ec != std::errc{} || result.ptr != last)
+		{
+			throw IniSettingValueCastError(std::string{ key.GetText() }, std::string{ value }, IniOptionTypeToString(optionType));
+		}
+	}
+	void IniOption::ConvertList(const std::vector<IniListElement>& elements)
+	{
+		// The list takes the widest type of its elements
+		IniOptionType elementType = IniOptionType::INTEGER;
+		std::size_t textSize = 0;
+		for (const IniListElement& element : elements)
+		{
+			if (element.elementType == IniOptionType::STRING)
+				elementType = IniOptionType::STRING;
+			else if (element.elementType == IniOptionType::FLOAT && elementType == IniOptionType::INTEGER)
+				elementType = IniOptionType::FLOAT;
+			textSize += element.text.size() + 4;
+		}
+
+		// Reserved up front, so the views of STRING elements aren't moved by the appends
+		value.clear();
+		value.reserve(textSize);
+		for (std::size_t element = 0; element < elements.size(); element++)
+		{
+			if (element != 0)
+				value += ", ";
+			if (elements[element].elementType == IniOptionType::STRING)
+			{
+				value += '"';
+				value += elements[element].text;
+				value += '"';
+			}
+			else
+			{
+				value += elements[element].text;
+			}
+		}
+
+		std::pmr::memory_resource* resource = value.get_allocator().resource();
+		if (elementType == IniOptionType::STRING)
+		{
+			auto& strings = array.emplace<std::pmr::vector<std::string_view>>(resource);
+			strings.reserve(elements.size());
+
+			const char* text = value.data();
+			for (const IniListElement& element : elements)
+			{
+				if (element.elementType == IniOptionType::STRING)
+					text++;
+				strings.emplace_back(text, element.text.size());
+				text += element.text.size() + (element.elementType == IniOptionType::STRING ? 3 : 2);
+			}
+			return;
+		}
+
+		// Numbers are converted in a single pass straight into the array
+		auto convert = [this, &elements](auto& numbers)
+		{
+			numbers.resize(elements.size());
+			for (std::size_t element = 0; element < elements.size(); element++)
+			{
+				const char* first = elements[element].text.data();
+				const char* last = first + elements[element].text.size();
+
+				std::from_chars_result result = std::from_chars(first, last, numbers[element]);
+				if (result.ec != std::errc{} || result.ptr != last)
+				{
+					throw IniSettingValueCastError(
+						std::string{ key.GetText() }, std::string{ elements[element].text }, IniOptionTypeToString(elements[element].elementType));
+				}
+			}
+		};
+		if (elementType == IniOptionType::INTEGER)
+			convert(array.emplace<std::pmr::vector<long long>>(resource));
+		else
+			convert(array.emplace<std::pmr::vector<double>>(resource));
+	}
+	void IniOption::CopyFrom(const IniOption& other)
+	{
+		value = other.value;
+		array = other.array;
+		optionType = other.optionType;
+		if (optionType == IniOptionType::FLOAT)
+			floatValue = other.floatValue;
+		else
+			integerValue = other.integerValue;
+
+		if (auto* strings = std::get_if<std::pmr::vector<std::string_view>>(&array))
+		{
+			for (std::string_view& element : *strings)
+				element = std::string_view{ value.data() + (element.data() - other.value.data()), element.size() };
+		}
+	}
+
 	// Ini Group
 
 	IniGroup::IniGroup(const std::string& iniGroupName)
-		: iniGroupName(iniGroupName)
+		: ownedArena(std::make_shared<IniArena>()),
+		arena(ownedArena.get()),
+		options(arena->GetResource()),
+		iniGroupName(iniGroupName, arena->GetResource())
+	{
+	}
+	IniGroup::IniGroup(std::string_view iniGroupName, IniArena& arena, IniSymbolTable* symbolTable)
+		: arena(&arena),
+		symbolTable(symbolTable),
+		options(arena.GetResource()),
+		iniGroupName(symbolTable ? IniName{ symbolTable->Intern(iniGroupName) } : IniName{ iniGroupName, arena.GetResource() })
 	{
 	}
 
 	void IniGroup::AddOption(std::shared_ptr<IniOption> iniOption)
 	{
-		options.insert({ iniOption->GetKey(), iniOption });
+		IniOption* option = iniOption.get();
+		arena->Adopt(std::move(iniOption));
+		options.Insert(option->GetKey(), option);
+	}
+
+	IniOption& IniGroup::CreateOption(std::string_view key, std::string_view value, IniOptionType optionType)
+	{
+		if (symbolTable)
+		{
+			IniSymbol symbol = symbolTable->Intern(key);
+			IniOption* option = arena->Create<IniOption>(symbol, value, optionType, arena->GetResource());
+			options.Insert(option->GetKey(), symbol.GetHash(), option);
+			return *option;
+		}
+
+		IniOption* option = arena->Create<IniOption>(key, value, optionType, arena->GetResource());
+		options.Insert(option->GetKey(), option);
+		return *option;
+	}
+
+	IniOption& IniGroup::CreateListOption(std::string_view key, const std::vector<IniListElement>& elements)
+	{
+		if (symbolTable)
+		{
+			IniSymbol symbol = symbolTable->Intern(key);
+			IniOption* option = arena->Create<IniOption>(symbol, elements, arena->GetResource());
+			options.Insert(option->GetKey(), symbol.GetHash(), option);
+			return *option;
+		}
+
+		IniOption* option = arena->Create<IniOption>(key, elements, arena->GetResource());
+		options.Insert(option->GetKey(), option);
+		return *option;
 	}
 
-	bool IniGroup::OptionExists(const std::string& key) const
+	bool IniGroup::OptionExists(std::string_view key) const
 	{
-		std::shared_ptr<IniOption> option = GetOption(key);
-		return option ? true : false;
+		return FindOption(key) != nullptr;
 	}
 
-	std::shared_ptr<IniOption> IniGroup::GetOption(const std::string& key) const
+	std::shared_ptr<IniOption> IniGroup::GetOption(std::string_view key) const
 	{
-		auto find = options.find(key);
-		if (find == options.end())
+		IniOption* option = FindOption(key);
+		if (!option)
 			return std::shared_ptr<IniOption>{};
-		return find->second;
+		return arena->Share(option);
+	}
+	IniOption* IniGroup::FindOption(std::string_view key) const noexcept
+	{
+		return options.Find(key);
+	}
+	IniOption* IniGroup::FindOption(const IniKey& key) const noexcept
+	{
+		return options.Find(key.GetName(), key.GetHash());
 	}
 
 	std::vector<std::shared_ptr<IniOption>> IniGroup::GetGroupOptions() const
 	{
 		std::vector<std::shared_ptr<IniOption>> groupOptions;
-		for (const auto& [optionName, option] : options)
+		groupOptions.reserve(options.Size());
+		for (const auto& entry : options)
 		{
-			groupOptions.push_back(option);
+			groupOptions.push_back(arena->Share(entry.value));
 		}
 		return groupOptions;
 	}
 
-	const std::string& IniGroup::GetGroupName() const
+	std::string_view IniGroup::GetGroupName() const
+	{
+		return iniGroupName.GetText();
+	}
+	IniSymbolId IniGroup::GetGroupNameSymbol() const
 	{
-		return iniGroupName;
+		return iniGroupName.GetSymbolId();
 	}
 
 	// Ini Settings
 
+	namespace
+	{
+		// Shared by all settings, 0 is never handed out
+		std::atomic<std::uint64_t> lastGeneration{ 0 };
+
+		std::uint64_t NextGeneration()
+		{
+			return lastGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+	}
+
 	IniSettings::IniSettings(const std::string& iniSettingsName)
-		: iniSettingsName(iniSettingsName)
+		: arena(std::make_shared<IniArena>()),
+		groups(arena->GetResource()),
+		iniSettingsName(iniSettingsName),
+		generation(NextGeneration())
 	{
 	}
 
 	void IniSettings::AddGroup(std::shared_ptr<IniGroup> iniGroup)
 	{
-		groups.insert({ iniGroup->GetGroupName(), iniGroup });
+		IniGroup* group = iniGroup.get();
+		arena->Adopt(std::move(iniGroup));
+		groups.Insert(group->GetGroupName(), group);
+		generation = NextGeneration();
+	}
+
+	void IniSettings::AddGroups(std::shared_ptr<IniSettings> iniSettings)
+	{
+		for (const auto& entry : iniSettings->groups)
+		{
+			groups.Insert(entry.key, entry.value);
+		}
+		if (iniSettings->groupLoader)
+		{
+			for (IniGroup* group : iniSettings->groupLoader->LoadGroups())
+				groups.Insert(group->GetGroupName(), group);
+		}
+		arena->Adopt(std::move(iniSettings));
+		generation = NextGeneration();
+	}
+
+	IniGroup& IniSettings::CreateGroup(std::string_view groupName)
+	{
+		IniGroup* group = arena->Create<IniGroup>(groupName, *arena, symbolTable);
+		groups.Insert(group->GetGroupName(), group);
+		generation = NextGeneration();
+		return *group;
 	}
-	std::shared_ptr<IniGroup> IniSettings::GetGroup(const std::string& groupName) const
+
+	void IniSettings::SetGroupLoader(std::shared_ptr<IniGroupLoader> groupLoader)
+	{
+		this->groupLoader = groupLoader.get();
+		arena->Adopt(std::move(groupLoader));
+		generation = NextGeneration();
+	}
+
+	void IniSettings::SetSymbolTable(std::shared_ptr<IniSymbolTable> symbolTable)
+	{
+		this->symbolTable = symbolTable.get();
+		arena->Adopt(std::move(symbolTable));
+	}
+
+	std::shared_ptr<IniGroup> IniSettings::GetGroup(std::string_view groupName) const
 	{
-		auto find = groups.find(groupName);
-		if (find == groups.end())
+		IniGroup* group = LoadGroup(groupName, HashKey(groupName));
+		if (!group)
 			return std::shared_ptr<IniGroup>{};
-		return find->second;
+		return arena->Share(group);
+	}
+	IniGroup* IniSettings::FindGroup(std::string_view groupName) const noexcept
+	{
+		return FindGroup(IniKey{ groupName });
+	}
+	IniGroup* IniSettings::FindGroup(const IniKey& groupName) const noexcept
+	{
+		try
+		{
+			return LoadGroup(groupName.GetName(), groupName.GetHash());
+		}
+		catch (...)
+		{
+			return nullptr;
+		}
 	}
 
 	std::vector<std::shared_ptr<IniGroup>> IniSettings::GetSettingsGroups() const
 	{
 		std::vector<std::shared_ptr<IniGroup>> settingsGroups;
-		for (const auto& [groupName, group] : groups)
+		settingsGroups.reserve(groups.Size());
+		for (const auto& entry : groups)
+		{
+			settingsGroups.push_back(arena->Share(entry.value));
+		}
+		if (groupLoader)
 		{
-			settingsGroups.push_back(group);
+			for (IniGroup* group : groupLoader->LoadGroups())
+			{
+				if (!groups.Find(group->GetGroupName()))
+					settingsGroups.push_back(arena->Share(group));
+			}
 		}
 		return settingsGroups;
 	}
@@ -96,6 +376,29 @@ namespace inip
 		return iniSettingsName;
 	}
 
+	IniGroup* IniSettings::LoadGroup(std::string_view groupName, std::uint64_t hash) const
+	{
+		IniGroup* group = groups.Find(groupName, hash);
+		if (!group && groupLoader)
+			group = groupLoader->LoadGroup(groupName, hash);
+		return group;
+	}
+
+	const IniArena& IniSettings::GetArena() const
+	{
+		return *arena;
+	}
+
+	// Ini Option Handle
+
+	void IniOptionHandle::Resolve(const IniSettings& iniSettings) noexcept
+	{
+		settingsGeneration = iniSettings.GetGeneration();
+		group = iniSettings.FindGroup(groupName);
+		groupGeneration = group ? group->GetGeneration() : 0;
+		option = group ? group->FindOption(key) : nullptr;
+	}
+
 	// Ini Settings Printer
 
 	void IniSettingsWriter::PrintIniSettings(std::ostream& outputStream, std::shared_ptr<IniSettings> iniSettings)
@@ -0,0 +1,55 @@
+#include "../../include/IniParser/IniArena.h"
+
+namespace inip
+{
+	IniArena::IniArena()
+	{
+	}
+	IniArena::~IniArena()
+	{
+		// Objects may refer to the ones created before them, so tear them down in reverse order
+		for (auto destructor = destructors.rbegin(); destructor != destructors.rend(); ++destructor)
+		{
+			destructor->destroy(destructor->object);
+		}
+		destructors.clear();
+		adopted.clear();
+	}
+
+	void IniArena::Adopt(std::shared_ptr<const void> object)
+	{
+		adopted.push_back(std::move(object));
+	}
+
+	std::pmr::memory_resource* IniArena::GetResource()
+	{
+		return &resource;
+	}
+
+	std::size_t IniArena::GetAllocatedBytes() const
+	{
+		return upstream.allocatedBytes;
+	}
+	std::size_t IniArena::GetAllocationsCount() const
+	{
+		return upstream.allocationsCount;
+	}
+
+	// CountingResource
+
+	void* IniArena::CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+	{
+		void* memory = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		allocatedBytes += bytes;
+		allocationsCount++;
+		return memory;
+	}
+	void IniArena::CountingResource::do_deallocate(void* memory, std::size_t bytes, std::size_t alignment)
+	{
+		std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+	}
+	bool IniArena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	{
+		return this == &other;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,469 @@
+#include "../../include/IniParser/IniCompiled.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace inip
+{
+	namespace
+	{
+		constexpr char compiledMagic[8]{ 'I', 'N', 'I', 'P', 'B', 'I', 'N', '\0' };
+		// Reads back as another value on a host of the other byte order
+		constexpr std::uint32_t compiledByteOrder{ 0x01020304 };
+
+		constexpr std::size_t sectionAlignment{ 8 };
+
+		std::size_t AlignSection(std::size_t offset)
+		{
+			return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+		}
+
+		// Power of two with at most half of the slots taken, zero for an empty table
+		std::uint32_t SlotsCount(std::size_t entriesCount)
+		{
+			if (entriesCount == 0)
+				return 0;
+			std::uint32_t slotsCount{ 2 };
+			while (slotsCount < entriesCount * 2)
+				slotsCount *= 2;
+			return slotsCount;
+		}
+
+		// Records are copied out of the buffer, so neither the file nor a caller's buffer has to be aligned
+		template <typename T>
+		T Load(const char* data)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			T value;
+			std::memcpy(&value, data, sizeof(T));
+			return value;
+		}
+		template <typename T>
+		void Store(std::string& buffer, std::size_t offset, const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			std::memcpy(buffer.data() + offset, &value, sizeof(T));
+		}
+
+		// Deduplicated strings, option keys repeat a lot across groups
+		class StringTable
+		{
+		public:
+
+			std::uint32_t Add(std::string_view string)
+			{
+				auto find = offsets.find(string);
+				if (find != offsets.end())
+					return find->second;
+
+				if (strings.size() + string.size() > std::numeric_limits<std::uint32_t>::max())
+					throw IniCompiledFormatError{ "The string table doesn't fit into 4 GiB!" };
+
+				std::uint32_t offset = static_cast<std::uint32_t>(strings.size());
+				strings.append(string);
+				offsets.emplace(string, offset);
+				return offset;
+			}
+
+			const std::string& GetStrings() const
+			{
+				return strings;
+			}
+
+		private:
+
+			std::string strings;
+			// Keys are views of the settings being compiled
+			std::unordered_map<std::string_view, std::uint32_t> offsets;
+		};
+
+		void InsertSlot(std::vector<std::uint32_t>& slots, std::size_t first, std::uint32_t slotsCount, std::uint64_t hash, std::uint32_t entry)
+		{
+			std::uint32_t mask = slotsCount - 1;
+			std::uint32_t slot = static_cast<std::uint32_t>(hash) & mask;
+			while (slots[first + slot] != 0)
+			{
+				slot = (slot + 1) & mask;
+			}
+			slots[first + slot] = entry + 1;
+		}
+	}
+
+	// IniCompiledFormatError
+
+	IniCompiledFormatError::IniCompiledFormatError(const std::string& reason)
+		: std::runtime_error("")
+	{
+		SetupErrorMessage(reason);
+	}
+
+	char const* IniCompiledFormatError::what() const noexcept
+	{
+		return message.c_str();
+	}
+
+	void IniCompiledFormatError::SetupErrorMessage(const std::string& reason)
+	{
+		std::stringstream stream{};
+		stream << "Unable to load compiled settings. " << "Reason: [" << reason << "]";
+		this->message = stream.str();
+	}
+
+	// Compilation
+
+	std::string CompileSettings(const IniSettings& iniSettings)
+	{
+		using Header = IniCompiledSettings::Header;
+		using GroupRecord = IniCompiledSettings::GroupRecord;
+		using OptionRecord = IniCompiledSettings::OptionRecord;
+
+		StringTable strings;
+
+		std::vector<GroupRecord> groups;
+		std::vector<OptionRecord> options;
+		std::vector<std::uint32_t> optionSlots;
+
+		Header header{};
+		std::memcpy(header.magic, compiledMagic, sizeof(compiledMagic));
+		header.version = iniCompiledVersion;
+		header.byteOrder = compiledByteOrder;
+		header.nameOffset = strings.Add(iniSettings.GetIniSettingsName());
+		header.nameSize = static_cast<std::uint32_t>(iniSettings.GetIniSettingsName().size());
+
+		for (const auto& iniGroup : iniSettings.GetSettingsGroups())
+		{
+			std::vector<std::shared_ptr<IniOption>> groupOptions = iniGroup->GetGroupOptions();
+
+			GroupRecord group{};
+			group.hash = HashKey(iniGroup->GetGroupName());
+			group.nameOffset = strings.Add(iniGroup->GetGroupName());
+			group.nameSize = static_cast<std::uint32_t>(iniGroup->GetGroupName().size());
+			group.firstOption = static_cast<std::uint32_t>(options.size());
+			group.optionsCount = static_cast<std::uint32_t>(groupOptions.size());
+			group.firstSlot = static_cast<std::uint32_t>(optionSlots.size());
+			group.slotsCount = SlotsCount(groupOptions.size());
+
+			optionSlots.resize(optionSlots.size() + group.slotsCount, 0);
+
+			for (const auto& iniOption : groupOptions)
+			{
+				std::string_view value = iniOption->TryGetValue<std::string_view>().GetValue();
+
+				OptionRecord option{};
+				option.hash = HashKey(iniOption->GetKey());
+				option.keyOffset = strings.Add(iniOption->GetKey());
+				option.keySize = static_cast<std::uint32_t>(iniOption->GetKey().size());
+				option.valueOffset = strings.Add(value);
+				option.valueSize = static_cast<std::uint32_t>(value.size());
+				option.optionType = static_cast<std::uint32_t>(iniOption->GetOptionType());
+
+				if (iniOption->GetOptionType() == IniOptionType::INTEGER)
+				{
+					long long integerValue = iniOption->GetValue<long long>();
+					std::memcpy(&option.numericValue, &integerValue, sizeof(integerValue));
+				}
+				else if (iniOption->GetOptionType() == IniOptionType::FLOAT)
+				{
+					double floatValue = iniOption->GetValue<double>();
+					std::memcpy(&option.numericValue, &floatValue, sizeof(floatValue));
+				}
+
+				InsertSlot(optionSlots, group.firstSlot, group.slotsCount, option.hash,
+					static_cast<std::uint32_t>(options.size()) - group.firstOption);
+				options.push_back(option);
+			}
+
+			groups.push_back(group);
+		}
+
+		std::vector<std::uint32_t> groupSlots(SlotsCount(groups.size()), 0);
+		for (std::uint32_t group = 0; group < groups.size(); group++)
+		{
+			InsertSlot(groupSlots, 0, static_cast<std::uint32_t>(groupSlots.size()), groups[group].hash, group);
+		}
+
+		header.groupsCount = static_cast<std::uint32_t>(groups.size());
+		header.groupSlotsCount = static_cast<std::uint32_t>(groupSlots.size());
+		header.optionsCount = static_cast<std::uint32_t>(options.size());
+		header.optionSlotsCount = static_cast<std::uint32_t>(optionSlots.size());
+
+		header.groupSlotsOffset = AlignSection(sizeof(Header));
+		header.groupsOffset = AlignSection(header.groupSlotsOffset + groupSlots.size() * sizeof(std::uint32_t));
+		header.optionSlotsOffset = AlignSection(header.groupsOffset + groups.size() * sizeof(GroupRecord));
+		header.optionsOffset = AlignSection(header.optionSlotsOffset + optionSlots.size() * sizeof(std::uint32_t));
+		header.stringsOffset = AlignSection(header.optionsOffset + options.size() * sizeof(OptionRecord));
+		header.stringsSize = strings.GetStrings().size();
+		header.fileSize = header.stringsOffset + header.stringsSize;
+
+		std::string compiled(header.fileSize, '\0');
+		for (std::size_t slot = 0; slot < groupSlots.size(); slot++)
+			Store(compiled, header.groupSlotsOffset + slot * sizeof(std::uint32_t), groupSlots[slot]);
+		for (std::size_t group = 0; group < groups.size(); group++)
+			Store(compiled, header.groupsOffset + group * sizeof(GroupRecord), groups[group]);
+		for (std::size_t slot = 0; slot < optionSlots.size(); slot++)
+			Store(compiled, header.optionSlotsOffset + slot * sizeof(std::uint32_t), optionSlots[slot]);
+		for (std::size_t option = 0; option < options.size(); option++)
+			Store(compiled, header.optionsOffset + option * sizeof(OptionRecord), options[option]);
+		std::memcpy(compiled.data() + header.stringsOffset, strings.GetStrings().data(), header.stringsSize);
+
+		header.checksum = HashKey(std::string_view{ compiled }.substr(sizeof(Header)));
+		Store(compiled, 0, header);
+
+		return compiled;
+	}
+
+	void WriteCompiledSettings(const IniSettings& iniSettings, const std::filesystem::path& filePath)
+	{
+		std::string compiled = CompileSettings(iniSettings);
+
+		std::ofstream compiledFile{ filePath, std::ios::binary | std::ios::trunc };
+		if (!compiledFile.write(compiled.data(), compiled.size()))
+		{
+			throw std::ofstream::failure{ "I/O runtime error while writing a file!" };
+		}
+	}
+
+	// IniCompiledGroup
+
+	std::string_view IniCompiledGroup::GetGroupName() const
+	{
+		IniCompiledSettings::GroupRecord record{};
+		if (!settings || !settings->ReadGroup(group, record))
+			return std::string_view{};
+		return settings->ReadString(record.nameOffset, record.nameSize);
+	}
+
+	std::size_t IniCompiledGroup::GetOptionsCount() const
+	{
+		IniCompiledSettings::GroupRecord record{};
+		if (!settings || !settings->ReadGroup(group, record))
+			return 0;
+		return record.optionsCount;
+	}
+	IniCompiledOption IniCompiledGroup::GetOption(std::size_t index) const
+	{
+		IniCompiledSettings::GroupRecord group{};
+		if (!settings || !settings->ReadGroup(this->group, group) || index >= group.optionsCount)
+			return IniCompiledOption{};
+
+		IniCompiledSettings::OptionRecord record{};
+		if (!settings->ReadOption(group.firstOption + static_cast<std::uint32_t>(index), record))
+			return IniCompiledOption{};
+
+		IniCompiledOption option{};
+		switch (static_cast<IniOptionType>(record.optionType))
+		{
+		case IniOptionType::INTEGER:
+			std::memcpy(&option.integerValue, &record.numericValue, sizeof(option.integerValue));
+			break;
+		case IniOptionType::FLOAT:
+			std::memcpy(&option.floatValue, &record.numericValue, sizeof(option.floatValue));
+			break;
+		case IniOptionType::STRING:
+		case IniOptionType::LIST:
+			break;
+		default:
+			return IniCompiledOption{};
+		}
+		option.key = settings->ReadString(record.keyOffset, record.keySize);
+		option.value = settings->ReadString(record.valueOffset, record.valueSize);
+		option.optionType = static_cast<IniOptionType>(record.optionType);
+		return option;
+	}
+
+	IniCompiledOption IniCompiledGroup::FindOption(std::string_view key) const noexcept
+	{
+		return FindOption(key, HashKey(key));
+	}
+	IniCompiledOption IniCompiledGroup::FindOption(const IniKey& key) const noexcept
+	{
+		return FindOption(key.GetName(), key.GetHash());
+	}
+	IniCompiledOption IniCompiledGroup::FindOption(std::string_view key, std::uint64_t hash) const noexcept
+	{
+		IniCompiledSettings::GroupRecord group{};
+		if (!settings || !settings->ReadGroup(this->group, group) || group.slotsCount == 0)
+			return IniCompiledOption{};
+
+		std::uint32_t mask = group.slotsCount - 1;
+		std::uint32_t slot = static_cast<std::uint32_t>(hash) & mask;
+		// Bounded, a corrupted table may have no empty slot
+		for (std::uint32_t probe = 0; probe < group.slotsCount; probe++)
+		{
+			std::uint32_t entry = settings->ReadSlot(settings->header.optionSlotsOffset, group.firstSlot + slot);
+			if (entry == 0 || entry > group.optionsCount)
+				break;
+
+			IniCompiledSettings::OptionRecord record{};
+			if (settings->ReadOption(group.firstOption + entry - 1, record) &&
+				record.hash == hash &&
+				settings->ReadString(record.keyOffset, record.keySize) == key)
+			{
+				return GetOption(entry - 1);
+			}
+
+			slot = (slot + 1) & mask;
+		}
+		return IniCompiledOption{};
+	}
+
+	// IniCompiledSettings
+
+	IniCompiledSettings::IniCompiledSettings(const std::filesystem::path& filePath, bool verifyChecksum)
+	{
+		Open(filePath, verifyChecksum);
+	}
+
+	void IniCompiledSettings::Open(const std::filesystem::path& filePath, bool verifyChecksum)
+	{
+		compiledFile.Open(filePath);
+		compiledData = compiledFile.GetContents();
+		Validate(verifyChecksum);
+	}
+	void IniCompiledSettings::OpenBuffer(std::string_view compiledData, bool verifyChecksum)
+	{
+		compiledFile.Close();
+		this->compiledData = compiledData;
+		Validate(verifyChecksum);
+	}
+
+	bool IniCompiledSettings::VerifyChecksum() const
+	{
+		if (compiledData.size() < sizeof(Header))
+			return false;
+		return HashKey(compiledData.substr(sizeof(Header))) == header.checksum;
+	}
+
+	std::string_view IniCompiledSettings::GetIniSettingsName() const
+	{
+		return ReadString(header.nameOffset, header.nameSize);
+	}
+
+	std::size_t IniCompiledSettings::GetGroupsCount() const
+	{
+		return header.groupsCount;
+	}
+	IniCompiledGroup IniCompiledSettings::GetGroup(std::size_t index) const
+	{
+		IniCompiledGroup group{};
+		if (index < header.groupsCount)
+		{
+			group.settings = this;
+			group.group = static_cast<std::uint32_t>(index);
+		}
+		return group;
+	}
+
+	IniCompiledGroup IniCompiledSettings::FindGroup(std::string_view groupName) const noexcept
+	{
+		return FindGroup(groupName, HashKey(groupName));
+	}
+	IniCompiledGroup IniCompiledSettings::FindGroup(const IniKey& groupName) const noexcept
+	{
+		return FindGroup(groupName.GetName(), groupName.GetHash());
+	}
+
+	void IniCompiledSettings::Validate(bool verifyChecksum)
+	{
+		// A file that fails to open leaves the settings empty
+		header = Header{};
+
+		if (compiledData.size() < sizeof(Header))
+			throw IniCompiledFormatError{ "The file is too small to hold a header!" };
+
+		Header loaded = Load<Header>(compiledData.data());
+
+		if (std::memcmp(loaded.magic, compiledMagic, sizeof(compiledMagic)) != 0)
+			throw IniCompiledFormatError{ "Not a compiled settings file!" };
+		if (loaded.byteOrder != compiledByteOrder)
+			throw IniCompiledFormatError{ "The file was compiled on a host of another byte order!" };
+		if (loaded.version != iniCompiledVersion)
+			throw IniCompiledFormatError{ "Unsupported version " + std::to_string(loaded.version) + "!" };
+		if (loaded.fileSize != compiledData.size())
+			throw IniCompiledFormatError{ "The file is truncated!" };
+
+		// Every section must lie within the file, then entries only need checking against their section
+		auto sectionFits = [&loaded](std::uint64_t offset, std::uint64_t count, std::uint64_t entrySize)
+		{
+			return offset <= loaded.fileSize && count <= (loaded.fileSize - offset) / entrySize;
+		};
+		if (!sectionFits(loaded.groupSlotsOffset, loaded.groupSlotsCount, sizeof(std::uint32_t)) ||
+			!sectionFits(loaded.groupsOffset, loaded.groupsCount, sizeof(GroupRecord)) ||
+			!sectionFits(loaded.optionSlotsOffset, loaded.optionSlotsCount, sizeof(std::uint32_t)) ||
+			!sectionFits(loaded.optionsOffset, loaded.optionsCount, sizeof(OptionRecord)) ||
+			!sectionFits(loaded.stringsOffset, loaded.stringsSize, 1))
+		{
+			throw IniCompiledFormatError{ "A section lies outside of the file!" };
+		}
+		if ((loaded.groupSlotsCount & (loaded.groupSlotsCount - 1)) != 0)
+			throw IniCompiledFormatError{ "The group table isn't a power of two!" };
+
+		if (verifyChecksum && HashKey(compiledData.substr(sizeof(Header))) != loaded.checksum)
+			throw IniCompiledFormatError{ "Checksum mismatch!" };
+
+		header = loaded;
+	}
+
+	IniCompiledGroup IniCompiledSettings::FindGroup(std::string_view groupName, std::uint64_t hash) const noexcept
+	{
+		if (header.groupSlotsCount == 0)
+			return IniCompiledGroup{};
+
+		std::uint32_t mask = header.groupSlotsCount - 1;
+		std::uint32_t slot = static_cast<std::uint32_t>(hash) & mask;
+		for (std::uint32_t probe = 0; probe < header.groupSlotsCount; probe++)
+		{
+			std::uint32_t entry = ReadSlot(header.groupSlotsOffset, slot);
+			if (entry == 0 || entry > header.groupsCount)
+				break;
+
+			GroupRecord record{};
+			if (ReadGroup(entry - 1, record) &&
+				record.hash == hash &&
+				ReadString(record.nameOffset, record.nameSize) == groupName)
+			{
+				return GetGroup(entry - 1);
+			}
+
+			slot = (slot + 1) & mask;
+		}
+		return IniCompiledGroup{};
+	}
+
+	bool IniCompiledSettings::ReadGroup(std::uint32_t index, GroupRecord& record) const noexcept
+	{
+		if (index >= header.groupsCount)
+			return false;
+
+		record = Load<GroupRecord>(compiledData.data() + header.groupsOffset + std::uint64_t{ index } * sizeof(GroupRecord));
+
+		// The options and the slots must lie within their sections, and the slots count must be a power of two
+		return record.firstOption <= header.optionsCount &&
+			record.optionsCount <= header.optionsCount - record.firstOption &&
+			record.firstSlot <= header.optionSlotsCount &&
+			record.slotsCount <= header.optionSlotsCount - record.firstSlot &&
+			(record.slotsCount & (record.slotsCount - 1)) == 0;
+	}
+	bool IniCompiledSettings::ReadOption(std::uint32_t index, OptionRecord& record) const noexcept
+	{
+		if (index >= header.optionsCount)
+			return false;
+
+		record = Load<OptionRecord>(compiledData.data() + header.optionsOffset + std::uint64_t{ index } * sizeof(OptionRecord));
+		return true;
+	}
+	std::uint32_t IniCompiledSettings::ReadSlot(std::uint64_t slotsOffset, std::uint32_t slot) const noexcept
+	{
+		return Load<std::uint32_t>(compiledData.data() + slotsOffset + std::uint64_t{ slot } * sizeof(std::uint32_t));
+	}
+	std::string_view IniCompiledSettings::ReadString(std::uint32_t offset, std::uint32_t size) const noexcept
+	{
+		if (offset > header.stringsSize || size > header.stringsSize - offset)
+			return std::string_view{};
+		return compiledData.substr(header.stringsOffset + offset, size);
+	}
+}
\ No newline at end of file
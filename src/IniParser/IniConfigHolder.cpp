@@ -0,0 +1,242 @@
+#include "../../include/IniParser/IniConfigHolder.h"
+#include "../../include/IniParser/IniParser.h"
+
+#include <system_error>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace inip
+{
+	namespace
+	{
+		// The holder a watcher thread watches for, 'watcher' itself is still being assigned when the thread starts
+		thread_local const IniConfigHolder* watchingHolder{ nullptr };
+	}
+
+	// Reader
+
+	IniConfigHolder::Reader::Reader(const IniConfigHolder& configHolder)
+		: configHolder(&configHolder)
+	{
+	}
+
+	const IniSettings& IniConfigHolder::Reader::Get()
+	{
+		std::uint64_t latestGeneration = configHolder->generation.load(std::memory_order_acquire);
+		if (!snapshot || latestGeneration != generation)
+		{
+			snapshot = configHolder->GetSnapshot();
+			generation = latestGeneration;
+		}
+		return *snapshot;
+	}
+
+	// IniConfigHolder
+
+	IniConfigHolder::IniConfigHolder(const std::filesystem::path& iniFilePath)
+		: iniFilePath(iniFilePath)
+	{
+		Publish(LoadSnapshot());
+	}
+	IniConfigHolder::~IniConfigHolder()
+	{
+		StopWatching();
+	}
+
+	std::shared_ptr<const IniSettings> IniConfigHolder::GetSnapshot() const
+	{
+		std::lock_guard<std::mutex> lock{ snapshotMutex };
+		return snapshot;
+	}
+	std::uint64_t IniConfigHolder::GetGeneration() const
+	{
+		return generation.load(std::memory_order_acquire);
+	}
+
+	bool IniConfigHolder::Reload()
+	{
+		std::shared_ptr<const IniSettings> newSnapshot;
+		std::exception_ptr error;
+		ReloadCallback callback;
+		{
+			std::lock_guard<std::mutex> lock{ reloadMutex };
+			try
+			{
+				newSnapshot = LoadSnapshot();
+				Publish(newSnapshot);
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+			callback = reloadCallback;
+		}
+
+		// Called without the lock, so the callback may reload or replace itself
+		if (callback)
+			callback(newSnapshot, error);
+		return !error;
+	}
+
+	void IniConfigHolder::SetReloadCallback(ReloadCallback reloadCallback)
+	{
+		std::lock_guard<std::mutex> lock{ reloadMutex };
+		this->reloadCallback = std::move(reloadCallback);
+	}
+
+	void IniConfigHolder::StartWatching(std::chrono::milliseconds pollInterval)
+	{
+		StopWatching();
+
+#if defined(__linux__)
+		if (pipe2(stopPipe, O_CLOEXEC) != 0)
+		{
+			throw std::system_error{ errno, std::generic_category(), "Unable to create the watcher's stop pipe!" };
+		}
+#endif
+
+		stopWatching = false;
+		watcher = std::thread{ &IniConfigHolder::Watch, this, pollInterval };
+	}
+	void IniConfigHolder::StopWatching()
+	{
+		// From the reload callback the watcher can't join itself, it stops once the callback returns
+		// and is joined by the next call made from another thread (the destructor at the latest)
+		bool fromWatcher = watchingHolder == this;
+		if (!fromWatcher && !watcher.joinable())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock{ watcherMutex };
+			stopWatching = true;
+		}
+		watcherStopped.notify_all();
+
+#if defined(__linux__)
+		char wakeUp{ 0 };
+		[[maybe_unused]] ssize_t written = write(stopPipe[1], &wakeUp, 1);
+#endif
+
+		if (fromWatcher)
+			return;
+
+		watcher.join();
+
+#if defined(__linux__)
+		close(stopPipe[0]);
+		close(stopPipe[1]);
+		stopPipe[0] = stopPipe[1] = -1;
+#endif
+	}
+
+	std::shared_ptr<const IniSettings> IniConfigHolder::LoadSnapshot() const
+	{
+		IniParser iniParser;
+		iniParser.SetParseMode(IniParseMode::STREAMING);
+		iniParser.Parse(iniFilePath);
+		return iniParser.GetIniSettings();
+	}
+	void IniConfigHolder::Publish(std::shared_ptr<const IniSettings> snapshot)
+	{
+		std::shared_ptr<const IniSettings> oldSnapshot;
+		{
+			std::lock_guard<std::mutex> lock{ snapshotMutex };
+			oldSnapshot = std::exchange(this->snapshot, std::move(snapshot));
+			generation.fetch_add(1, std::memory_order_release);
+		}
+		// If no reader holds the old snapshot it's freed here, outside of the lock
+	}
+
+	void IniConfigHolder::Watch(std::chrono::milliseconds pollInterval)
+	{
+		watchingHolder = this;
+
+		// Without notifications (once the inotify watches limit is reached, or if they fail) the write time is polled instead
+		if (!WatchNotifications())
+			WatchWriteTime(pollInterval);
+	}
+
+	bool IniConfigHolder::WatchNotifications()
+	{
+#if defined(__linux__)
+		int inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotifyFd < 0)
+			return false;
+
+		// Editors and deploy tools often replace the file with a rename, so the directory is watched
+		std::filesystem::path directory = iniFilePath.parent_path();
+		if (directory.empty())
+			directory = ".";
+		std::string fileName = iniFilePath.filename().string();
+
+		if (inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+		{
+			close(inotifyFd);
+			return false;
+		}
+
+		alignas(inotify_event) char events[4096];
+		while (true)
+		{
+			pollfd fds[2]{ { inotifyFd, POLLIN, 0 }, { stopPipe[0], POLLIN, 0 } };
+			if (poll(fds, 2, -1) < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				// The write time is polled from here on
+				close(inotifyFd);
+				return false;
+			}
+			if (fds[1].revents != 0)
+				break;
+
+			bool changed = false;
+			ssize_t length = 0;
+			while ((length = read(inotifyFd, events, sizeof(events))) > 0)
+			{
+				for (char* event = events; event < events + length; )
+				{
+					const inotify_event* notification = reinterpret_cast<const inotify_event*>(event);
+					if (notification->len != 0 && fileName == notification->name)
+						changed = true;
+					event += sizeof(inotify_event) + notification->len;
+				}
+			}
+
+			if (changed)
+				Reload();
+		}
+
+		close(inotifyFd);
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void IniConfigHolder::WatchWriteTime(std::chrono::milliseconds pollInterval)
+	{
+		std::error_code errorCode;
+		std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(iniFilePath, errorCode);
+
+		std::unique_lock<std::mutex> lock{ watcherMutex };
+		while (!watcherStopped.wait_for(lock, pollInterval, [this]() { return stopWatching; }))
+		{
+			std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(iniFilePath, errorCode);
+			if (errorCode || writeTime == lastWriteTime)
+				continue;
+
+			lastWriteTime = writeTime;
+
+			lock.unlock();
+			Reload();
+			lock.lock();
+		}
+	}
+}
\ No newline at end of file
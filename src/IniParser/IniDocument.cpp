@@ -0,0 +1,334 @@
+#include "../../include/IniParser/IniDocument.h"
+#include "../../include/IniParser/IniEventHandler.h"
+#include "../../include/IniParser/IniMappedFile.h"
+#include "../../include/IniParser/IniParser.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace inip
+{
+	namespace
+	{
+		// The event API hands out views into the source, their offsets are the spans
+		template <typename GroupNode, typename OptionNode>
+		class DocumentBuilder : public IniEventHandler
+		{
+		public:
+
+			DocumentBuilder(
+				std::string_view iniSource,
+				std::vector<GroupNode>& groups,
+				std::map<std::string, std::size_t, std::less<>>& groupsByName)
+				: iniSource(iniSource), groups(groups), groupsByName(groupsByName)
+			{
+			}
+
+			bool OnGroupBegin(std::string_view groupName, int /*line*/) override
+			{
+				std::size_t nameBegin = OffsetOf(groupName);
+				std::size_t nameEnd = nameBegin + groupName.size();
+
+				GroupNode group{};
+				group.headerBegin = iniSource.rfind('[', nameBegin);
+				group.headerEnd = iniSource.find(']', nameEnd) + 1;
+
+				groupsByName.emplace(std::string{ groupName }, groups.size());
+				groups.push_back(std::move(group));
+				return true;
+			}
+			bool OnOption(std::string_view key, std::string_view value, IniOptionType optionType, int /*line*/) override
+			{
+				OptionNode option{};
+				option.keyBegin = OffsetOf(key);
+				option.valueBegin = OffsetOf(value);
+				option.valueEnd = option.valueBegin + value.size();
+
+				// STRING values come without their quotes
+				if (optionType == IniOptionType::STRING && option.valueBegin > 0 && iniSource[option.valueBegin - 1] == '"')
+				{
+					option.valueBegin--;
+					option.valueEnd++;
+				}
+
+				GroupNode& group = groups.back();
+				group.optionsByKey.emplace(std::string{ key }, group.options.size());
+				group.options.push_back(option);
+				return true;
+			}
+
+		private:
+
+			std::size_t OffsetOf(std::string_view view) const
+			{
+				return static_cast<std::size_t>(view.data() - iniSource.data());
+			}
+
+			std::string_view iniSource;
+			std::vector<GroupNode>& groups;
+			std::map<std::string, std::size_t, std::less<>>& groupsByName;
+		};
+
+		// Where the line a statement ends on ends, past the comments that follow the statement.
+		// A multi line comment is followed to the line it's closed on.
+		// Stops early at a statement that shares the line.
+		std::size_t StatementLineEnd(std::string_view iniSource, std::size_t position)
+		{
+			while (position < iniSource.size() && iniSource[position] != '\n')
+			{
+				if (iniSource.compare(position, 2, "//") == 0)
+				{
+					position = std::min(iniSource.find('\n', position), iniSource.size());
+				}
+				else if (iniSource.compare(position, 2, "/*") == 0)
+				{
+					std::size_t commentEnd = iniSource.find("*/", position + 2);
+					position = commentEnd == std::string_view::npos ? iniSource.size() : commentEnd + 2;
+				}
+				else if (iniSource[position] == ' ' || iniSource[position] == '\t' || iniSource[position] == '\r')
+				{
+					position++;
+				}
+				else
+				{
+					break;
+				}
+			}
+			return position;
+		}
+	}
+
+	// IniDocument
+
+	IniDocument::IniDocument(std::string iniSource)
+	{
+		Load(std::move(iniSource));
+	}
+
+	void IniDocument::Open(const std::filesystem::path& iniFilePath)
+	{
+		IniMappedFile iniFile{ iniFilePath };
+		Load(std::string{ iniFile.GetContents() });
+	}
+	void IniDocument::Load(std::string iniSource)
+	{
+		std::vector<GroupNode> newGroups;
+		std::map<std::string, std::size_t, std::less<>> newGroupsByName;
+		DocumentBuilder<GroupNode, OptionNode> builder{ iniSource, newGroups, newGroupsByName };
+
+		IniParser iniParser;
+		iniParser.ParseEvents(iniSource, builder);
+
+		// Nothing changes if the source fails to parse
+		this->iniSource = std::move(iniSource);
+		groups = std::move(newGroups);
+		groupsByName = std::move(newGroupsByName);
+		dirtyBegin = std::string::npos;
+	}
+
+	const std::string& IniDocument::GetSource() const
+	{
+		return iniSource;
+	}
+
+	bool IniDocument::GroupExists(std::string_view groupName) const
+	{
+		return groupsByName.find(groupName) != groupsByName.end();
+	}
+	bool IniDocument::OptionExists(std::string_view groupName, std::string_view key) const
+	{
+		return FindOption(groupName, key) != nullptr;
+	}
+
+	std::string_view IniDocument::GetValueText(std::string_view groupName, std::string_view key) const
+	{
+		const OptionNode* option = FindOption(groupName, key);
+		if (!option)
+			return std::string_view{};
+		return std::string_view{ iniSource }.substr(option->valueBegin, option->valueEnd - option->valueBegin);
+	}
+
+	bool IniDocument::SetValue(std::string_view groupName, std::string_view key, std::string_view value)
+	{
+		return SetValueText(groupName, key, IniWriter::FormatStringValue(value));
+	}
+	bool IniDocument::SetValueText(std::string_view groupName, std::string_view key, const std::string& valueText)
+	{
+		const OptionNode* option = FindOption(groupName, key);
+		if (!option)
+			return false;
+
+		Splice(option->valueBegin, option->valueEnd, valueText);
+		return true;
+	}
+
+	void IniDocument::InsertOption(std::string_view groupName, std::string_view key, std::string_view value)
+	{
+		InsertOptionText(groupName, key, IniWriter::FormatStringValue(value));
+	}
+	void IniDocument::InsertOptionText(std::string_view groupName, std::string_view key, const std::string& valueText)
+	{
+		if (SetValueText(groupName, key, valueText))
+			return;
+
+		IniWriter::CheckKey(key);
+
+		auto find = groupsByName.find(groupName);
+		if (find == groupsByName.end())
+		{
+			std::string groupHeader = "[" + IniWriter::FormatGroupName(groupName) + "]";
+
+			// Groups are separated by an empty line, like 'IniWriter' does
+			std::string text;
+			if (!iniSource.empty())
+				text = iniSource.back() == '\n' ? "\n" : "\n\n";
+
+			GroupNode group{};
+			group.headerBegin = iniSource.size() + text.size();
+			group.headerEnd = group.headerBegin + groupHeader.size();
+
+			text += groupHeader;
+			text += '\n';
+
+			OptionNode option{};
+			option.keyBegin = iniSource.size() + text.size();
+			option.valueBegin = option.keyBegin + key.size() + 3;
+			option.valueEnd = option.valueBegin + valueText.size();
+
+			text += key;
+			text += " = ";
+			text += valueText;
+			text += '\n';
+
+			Splice(iniSource.size(), iniSource.size(), text);
+
+			group.optionsByKey.emplace(std::string{ key }, 0);
+			group.options.push_back(option);
+			groupsByName.emplace(std::string{ groupName }, groups.size());
+			groups.push_back(std::move(group));
+			return;
+		}
+
+		GroupNode& group = groups[find->second];
+
+		// On the line after the last option, indented like it, or on the line after the header.
+		// A comment that follows them stays on their line.
+		std::size_t statementEnd = group.headerEnd;
+		std::string_view indentation{};
+		if (!group.options.empty())
+		{
+			const OptionNode& last = group.options.back();
+			statementEnd = last.valueEnd;
+
+			std::size_t lineBegin = iniSource.rfind('\n', last.keyBegin);
+			lineBegin = lineBegin == std::string::npos ? 0 : lineBegin + 1;
+			indentation = std::string_view{ iniSource }.substr(lineBegin, last.keyBegin - lineBegin);
+			if (indentation.find_first_not_of(" \t") != std::string_view::npos)
+				indentation = std::string_view{};
+		}
+
+		std::size_t position = StatementLineEnd(iniSource, statementEnd);
+
+		std::string text;
+		text += '\n';
+		text += indentation;
+
+		OptionNode option{};
+		option.keyBegin = position + text.size();
+		option.valueBegin = option.keyBegin + key.size() + 3;
+		option.valueEnd = option.valueBegin + valueText.size();
+
+		text += key;
+		text += " = ";
+		text += valueText;
+		// A statement that shares the line moves to the next one
+		if (position < iniSource.size() && iniSource[position] != '\n')
+			text += '\n';
+
+		Splice(position, position, text);
+
+		group.optionsByKey.emplace(std::string{ key }, group.options.size());
+		group.options.push_back(option);
+	}
+
+	void IniDocument::Save(const std::filesystem::path& iniFilePath)
+	{
+		std::ofstream iniFile{ iniFilePath, std::ios::binary | std::ios::trunc };
+		if (!iniFile.write(iniSource.data(), static_cast<std::streamsize>(iniSource.size())))
+		{
+			throw std::ofstream::failure{ "I/O runtime error while writing a file!" };
+		}
+		dirtyBegin = std::string::npos;
+	}
+	void IniDocument::SaveInPlace(const std::filesystem::path& iniFilePath)
+	{
+		if (dirtyBegin == std::string::npos)
+			return;
+
+		{
+			std::fstream iniFile{ iniFilePath, std::ios::in | std::ios::out | std::ios::binary };
+			if (!iniFile)
+			{
+				throw std::ofstream::failure{ "I/O runtime error while openning a file!" };
+			}
+
+			iniFile.seekp(static_cast<std::streamoff>(dirtyBegin));
+			if (!iniFile.write(iniSource.data() + dirtyBegin, static_cast<std::streamsize>(iniSource.size() - dirtyBegin)))
+			{
+				throw std::ofstream::failure{ "I/O runtime error while writing a file!" };
+			}
+		}
+
+		// The source may have shrunk
+		std::filesystem::resize_file(iniFilePath, iniSource.size());
+		dirtyBegin = std::string::npos;
+	}
+
+	const IniDocument::OptionNode* IniDocument::FindOption(std::string_view groupName, std::string_view key) const
+	{
+		auto group = groupsByName.find(groupName);
+		if (group == groupsByName.end())
+			return nullptr;
+
+		const GroupNode& node = groups[group->second];
+		auto option = node.optionsByKey.find(key);
+		if (option == node.optionsByKey.end())
+			return nullptr;
+		return &node.options[option->second];
+	}
+
+	void IniDocument::Splice(std::size_t begin, std::size_t end, std::string_view text)
+	{
+		iniSource.replace(begin, end - begin, text);
+		ShiftSpans(begin, end, static_cast<std::ptrdiff_t>(text.size()) - static_cast<std::ptrdiff_t>(end - begin));
+		dirtyBegin = std::min(dirtyBegin, begin);
+	}
+	void IniDocument::ShiftSpans(std::size_t begin, std::size_t end, std::ptrdiff_t delta)
+	{
+		// A span that begins at 'end' follows the spliced bytes.
+		// A span that ends at 'end' is the replaced value itself, unless nothing was replaced,
+		// then it's the token the text was inserted after.
+		auto shiftBegin = [=](std::size_t& offset)
+		{
+			if (offset >= end)
+				offset += delta;
+		};
+		auto shiftEnd = [=](std::size_t& offset)
+		{
+			if (offset > begin)
+				offset += delta;
+		};
+
+		for (GroupNode& group : groups)
+		{
+			shiftBegin(group.headerBegin);
+			shiftEnd(group.headerEnd);
+			for (OptionNode& option : group.options)
+			{
+				shiftBegin(option.keyBegin);
+				shiftBegin(option.valueBegin);
+				shiftEnd(option.valueEnd);
+			}
+		}
+	}
+}
\ No newline at end of file
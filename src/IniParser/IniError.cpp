@@ -15,7 +15,7 @@ namespace inip
 		SetupErrorMessage(key, value, castType);
 	}
 
-	char const* IniSettingValueCastError::what() const
+	char const* IniSettingValueCastError::what() const noexcept
 	{
 		return message.c_str();
 	}
@@ -40,7 +40,7 @@ namespace inip
 		SetupErrorMessage(key);
 	}
 
-	_NODISCARD char const* IniSettingOptionNotFoundError::what() const
+	char const* IniSettingOptionNotFoundError::what() const noexcept
 	{
 		return message.c_str();
 	}
@@ -51,4 +51,22 @@ namespace inip
 		stream << "Unable to find a key. " << "Key: [" << key << "]";
 		this->message = stream.str();
 	}
+
+	// IniErrorCode
+
+	std::string_view IniErrorCodeToString(IniErrorCode errorCode)
+	{
+		switch (errorCode)
+		{
+		case IniErrorCode::NONE:
+			return "NONE";
+		case IniErrorCode::GROUP_NOT_FOUND:
+			return "GROUP_NOT_FOUND";
+		case IniErrorCode::OPTION_NOT_FOUND:
+			return "OPTION_NOT_FOUND";
+		case IniErrorCode::VALUE_CAST_ERROR:
+			return "VALUE_CAST_ERROR";
+		}
+		return "UNIDENTIFIED";
+	}
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "../../include/IniParser/IniIncrementalParser.h"
+#include "../../include/IniParser/IniMappedFile.h"
+#include "../../include/IniParser/IniParser.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace inip
+{
+	std::string IniChangeTypeToString(IniChangeType changeType)
+	{
+		switch (changeType)
+		{
+		case IniChangeType::ADDED:
+			return "ADDED";
+		case IniChangeType::REMOVED:
+			return "REMOVED";
+		case IniChangeType::MODIFIED:
+			return "MODIFIED";
+		}
+		return "UNIDENTIFIED";
+	}
+
+	// IniIncrementalParser
+
+	IniIncrementalParser::IniIncrementalParser(const std::string& iniSettingsName)
+		: iniSettingsName(iniSettingsName)
+	{
+	}
+
+	IniChangeSet IniIncrementalParser::Update(std::string iniSource)
+	{
+		std::vector<IniSourceSpan> spans = IniScanner::SplitAtGroups(iniSource);
+
+		// Old chunks by the hash of their text, a chunk can only be reused once
+		std::unordered_multimap<std::uint64_t, std::size_t> oldChunks;
+		oldChunks.reserve(chunks.size());
+		for (std::size_t chunk = 0; chunk < chunks.size(); chunk++)
+		{
+			oldChunks.emplace(chunks[chunk].hash, chunk);
+		}
+		std::vector<bool> reused(chunks.size(), false);
+
+		// Names of the groups that may have changed, duplicates are dropped later
+		std::vector<std::string_view> changedGroups;
+
+		std::vector<Chunk> newChunks;
+		newChunks.reserve(spans.size());
+		for (const IniSourceSpan& span : spans)
+		{
+			Chunk newChunk{};
+			newChunk.text = std::string_view{ iniSource }.substr(span.begin, span.end - span.begin);
+			newChunk.hash = HashKey(newChunk.text);
+
+			auto [first, last] = oldChunks.equal_range(newChunk.hash);
+			for (auto oldChunk = first; oldChunk != last; ++oldChunk)
+			{
+				std::size_t index = oldChunk->second;
+				if (!reused[index] && chunks[index].text == newChunk.text)
+				{
+					reused[index] = true;
+					newChunk.chunkSettings = chunks[index].chunkSettings;
+					break;
+				}
+			}
+
+			if (!newChunk.chunkSettings)
+			{
+				newChunk.chunkSettings = ParseChunk(newChunk.text, span.line);
+				for (const auto& group : newChunk.chunkSettings->GetSettingsGroups())
+				{
+					changedGroups.push_back(group->GetGroupName());
+				}
+			}
+
+			newChunks.push_back(std::move(newChunk));
+		}
+
+		for (std::size_t chunk = 0; chunk < chunks.size(); chunk++)
+		{
+			if (reused[chunk])
+				continue;
+			for (const auto& group : chunks[chunk].chunkSettings->GetSettingsGroups())
+			{
+				changedGroups.push_back(group->GetGroupName());
+			}
+		}
+
+		std::shared_ptr<IniSettings> newSettings = std::make_shared<IniSettings>(iniSettingsName);
+		for (const Chunk& chunk : newChunks)
+		{
+			newSettings->AddGroups(chunk.chunkSettings);
+		}
+
+		IniChangeSet changeSet{};
+		DiffGroups(iniSettings.get(), *newSettings, changedGroups, changeSet);
+
+		// The old chunks' text isn't needed past this point
+		this->iniSource = std::move(iniSource);
+		chunks = std::move(newChunks);
+		iniSettings = std::move(newSettings);
+
+		return changeSet;
+	}
+	IniChangeSet IniIncrementalParser::Update(const std::filesystem::path& iniFilePath)
+	{
+		IniMappedFile iniFile{ iniFilePath };
+		return Update(std::string{ iniFile.GetContents() });
+	}
+
+	std::shared_ptr<IniSettings> IniIncrementalParser::GetIniSettings() const
+	{
+		return iniSettings;
+	}
+
+	std::shared_ptr<IniSettings> IniIncrementalParser::ParseChunk(std::string_view chunkText, int firstLine) const
+	{
+		IniParser chunkParser;
+		chunkParser.iniSettings = std::make_shared<IniSettings>(iniSettingsName);
+		chunkParser.ParseSource(chunkText, firstLine, true);
+		return chunkParser.iniSettings;
+	}
+
+	void IniIncrementalParser::DiffGroups(
+		const IniSettings* oldSettings, const IniSettings& newSettings,
+		const std::vector<std::string_view>& groupNames,
+		IniChangeSet& changeSet)
+	{
+		std::unordered_set<std::string_view> visited;
+		std::vector<IniGroupChange> removedGroups;
+
+		for (std::string_view groupName : groupNames)
+		{
+			if (!visited.insert(groupName).second)
+				continue;
+
+			const IniGroup* oldGroup = oldSettings ? oldSettings->FindGroup(groupName) : nullptr;
+			const IniGroup* newGroup = newSettings.FindGroup(groupName);
+
+			// The same group object, a changed duplicate didn't take its place
+			if (oldGroup == newGroup)
+				continue;
+
+			IniGroupChange groupChange{};
+			groupChange.groupName = std::string{ groupName };
+
+			if (!oldGroup)
+			{
+				groupChange.changeType = IniChangeType::ADDED;
+			}
+			else if (!newGroup)
+			{
+				groupChange.changeType = IniChangeType::REMOVED;
+				removedGroups.push_back(std::move(groupChange));
+				continue;
+			}
+			else
+			{
+				groupChange.changeType = IniChangeType::MODIFIED;
+				DiffOptions(*oldGroup, *newGroup, groupChange);
+				// The text changed but the options didn't (comments, formatting)
+				if (groupChange.optionChanges.empty())
+					continue;
+			}
+
+			changeSet.groupChanges.push_back(std::move(groupChange));
+		}
+
+		for (IniGroupChange& groupChange : removedGroups)
+		{
+			changeSet.groupChanges.push_back(std::move(groupChange));
+		}
+	}
+	void IniIncrementalParser::DiffOptions(const IniGroup& oldGroup, const IniGroup& newGroup, IniGroupChange& groupChange)
+	{
+		for (const auto& newOption : newGroup.GetGroupOptions())
+		{
+			std::string_view newValue = newOption->TryGetValue<std::string_view>().GetValue();
+
+			const IniOption* oldOption = oldGroup.FindOption(newOption->GetKey());
+			if (!oldOption)
+			{
+				groupChange.optionChanges.push_back(IniOptionChange{
+					IniChangeType::ADDED, std::string{ newOption->GetKey() }, std::string{}, std::string{ newValue } });
+				continue;
+			}
+
+			std::string_view oldValue = oldOption->TryGetValue<std::string_view>().GetValue();
+			if (oldValue != newValue || oldOption->GetOptionType() != newOption->GetOptionType())
+			{
+				groupChange.optionChanges.push_back(IniOptionChange{
+					IniChangeType::MODIFIED, std::string{ newOption->GetKey() }, std::string{ oldValue }, std::string{ newValue } });
+			}
+		}
+
+		for (const auto& oldOption : oldGroup.GetGroupOptions())
+		{
+			if (newGroup.OptionExists(oldOption->GetKey()))
+				continue;
+
+			std::string_view oldValue = oldOption->TryGetValue<std::string_view>().GetValue();
+			groupChange.optionChanges.push_back(IniOptionChange{
+				IniChangeType::REMOVED, std::string{ oldOption->GetKey() }, std::string{ oldValue }, std::string{} });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "IniLazyGroupLoader.h"
+
+#include "../../include/IniParser/IniParser.h"
+
+namespace inip
+{
+	IniLazyGroupLoader::IniLazyGroupLoader(
+		std::string_view iniSource,
+		std::shared_ptr<const void> sourceOwner,
+		const std::string& iniSettingsName,
+		std::shared_ptr<IniSymbolTable> symbolTable)
+		: iniSource(iniSource),
+		sourceOwner(std::move(sourceOwner)),
+		iniSettingsName(iniSettingsName),
+		symbolTable(std::move(symbolTable))
+	{
+		struct GroupHeader
+		{
+			std::string_view groupName;
+			IniSourceSpan span;
+		};
+
+		// A source without any group is a single span of comments, it has no header
+		IniParser headerParser;
+		std::vector<GroupHeader> headers;
+		for (const IniSourceSpan& span : IniScanner::SplitAtGroups(iniSource))
+		{
+			GroupHeader header{ {}, span };
+			if (headerParser.ScanGroupHeader(iniSource.substr(span.begin, span.end - span.begin), span.line, header.groupName))
+				headers.push_back(header);
+		}
+
+		// Atomics can't be moved, the entries are constructed in place once
+		entries = std::vector<GroupEntry>(headers.size());
+		for (std::size_t group = 0; group < headers.size(); group++)
+		{
+			entries[group].groupName = headers[group].groupName;
+			entries[group].span = headers[group].span;
+		}
+
+		for (GroupEntry& entry : entries)
+			groupsByName.Insert(entry.groupName, &entry);
+	}
+
+	IniGroup* IniLazyGroupLoader::LoadGroup(std::string_view groupName, std::uint64_t hash)
+	{
+		GroupEntry* entry = groupsByName.Find(groupName, hash);
+		if (!entry)
+			return nullptr;
+		return BuildGroup(*entry);
+	}
+	std::vector<IniGroup*> IniLazyGroupLoader::LoadGroups()
+	{
+		std::vector<IniGroup*> groups;
+		groups.reserve(groupsByName.Size());
+		for (const auto& entry : groupsByName)
+		{
+			groups.push_back(BuildGroup(*entry.value));
+		}
+		return groups;
+	}
+
+	std::size_t IniLazyGroupLoader::GetGroupsCount() const
+	{
+		return groupsByName.Size();
+	}
+
+	IniGroup* IniLazyGroupLoader::BuildGroup(GroupEntry& entry)
+	{
+		IniGroup* group = entry.group.load(std::memory_order_acquire);
+		if (group)
+			return group;
+
+		std::lock_guard<std::mutex> lock{ mutex };
+		group = entry.group.load(std::memory_order_relaxed);
+		if (group)
+			return group;
+
+		IniParser groupParser;
+		groupParser.symbolTable = symbolTable;
+		groupParser.iniSettings = groupParser.CreateSettings(iniSettingsName);
+		groupParser.ParseSource(iniSource.substr(entry.span.begin, entry.span.end - entry.span.begin), entry.span.line, true);
+
+		entry.groupSettings = groupParser.iniSettings;
+		group = entry.groupSettings->FindGroup(entry.groupName);
+		entry.group.store(group, std::memory_order_release);
+		return group;
+	}
+}
\ No newline at end of file
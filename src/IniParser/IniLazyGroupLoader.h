@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../../include/IniParser/Ini.h"
+#include "../../include/IniParser/IniScanner.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inip
+{
+	// Loader of a LAZY parse. The pre-pass in the constructor finds the groups and reads their headers,
+	// a group is then parsed into settings of its own the first time it's looked up.
+	// The index is never changed after the pre-pass and a built group is published through an atomic pointer,
+	// so lookups of built groups don't lock, building one takes the loader's mutex.
+
+	class IniLazyGroupLoader : public IniGroupLoader
+	{
+	public:
+
+		// 'sourceOwner' keeps 'iniSource' alive
+		IniLazyGroupLoader(
+			std::string_view iniSource,
+			std::shared_ptr<const void> sourceOwner,
+			const std::string& iniSettingsName,
+			std::shared_ptr<IniSymbolTable> symbolTable);
+
+		IniGroup* LoadGroup(std::string_view groupName, std::uint64_t hash) override;
+		std::vector<IniGroup*> LoadGroups() override;
+
+		// Duplicates aren't counted, like the settings don't register them
+		std::size_t GetGroupsCount() const;
+
+	private:
+
+		struct GroupEntry
+		{
+			// View into the source
+			std::string_view groupName;
+			IniSourceSpan span;
+
+			// Written under the mutex, before 'group' is published
+			std::shared_ptr<IniSettings> groupSettings;
+			std::atomic<IniGroup*> group{ nullptr };
+		};
+
+		IniGroup* BuildGroup(GroupEntry& entry);
+
+		std::string_view iniSource;
+		std::shared_ptr<const void> sourceOwner;
+		std::string iniSettingsName;
+		// Null unless the parse interns its names
+		std::shared_ptr<IniSymbolTable> symbolTable;
+
+		// File order, duplicates included
+		std::vector<GroupEntry> entries;
+		// First entry of every name
+		IniFlatMap<GroupEntry> groupsByName;
+
+		std::mutex mutex;
+	};
+}
\ No newline at end of file
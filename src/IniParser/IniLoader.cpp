@@ -0,0 +1,148 @@
+#include "../../include/IniParser/IniLoader.h"
+
+#include "IniParallel.h"
+
+#include <algorithm>
+
+namespace inip
+{
+	namespace
+	{
+		// Wildcard match of a whole name, '*' matches any run of characters and '?' a single one
+		bool MatchesPattern(std::string_view name, std::string_view pattern)
+		{
+			std::size_t n = 0;
+			std::size_t p = 0;
+
+			// Where to resume after the last '*' if the rest doesn't match
+			std::size_t starPattern = std::string_view::npos;
+			std::size_t starName = 0;
+
+			while (n < name.size())
+			{
+				if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n]))
+				{
+					n++;
+					p++;
+				}
+				else if (p < pattern.size() && pattern[p] == '*')
+				{
+					starPattern = p++;
+					starName = n;
+				}
+				else if (starPattern != std::string_view::npos)
+				{
+					p = starPattern + 1;
+					n = ++starName;
+				}
+				else
+				{
+					return false;
+				}
+			}
+
+			while (p < pattern.size() && pattern[p] == '*')
+			{
+				p++;
+			}
+			return p == pattern.size();
+		}
+	}
+
+	// IniLoader
+
+	void IniLoader::SetThreadsCount(unsigned threadsCount)
+	{
+		this->threadsCount = threadsCount;
+	}
+	unsigned IniLoader::GetThreadsCount() const
+	{
+		return threadsCount;
+	}
+
+	void IniLoader::SetParseMode(IniParseMode parseMode)
+	{
+		this->parseMode = parseMode;
+	}
+	IniParseMode IniLoader::GetParseMode() const
+	{
+		return parseMode;
+	}
+
+	std::vector<IniLoadResult> IniLoader::Load(const std::vector<std::filesystem::path>& iniFilePaths) const
+	{
+		std::vector<IniLoadResult> results(iniFilePaths.size());
+		ParallelFor(iniFilePaths.size(), threadsCount, [&](std::size_t file)
+		{
+			results[file] = LoadFile(iniFilePaths[file]);
+		});
+		return results;
+	}
+
+	std::vector<IniLoadResult> IniLoader::LoadDirectory(
+		const std::filesystem::path& directory,
+		std::string_view pattern,
+		bool recursive) const
+	{
+		std::vector<std::filesystem::path> iniFilePaths;
+
+		auto addFile = [&](const std::filesystem::directory_entry& entry)
+		{
+			if (entry.is_regular_file() && MatchesPattern(entry.path().filename().generic_string(), pattern))
+				iniFilePaths.push_back(entry.path());
+		};
+
+		if (recursive)
+		{
+			for (const auto& entry : std::filesystem::recursive_directory_iterator{ directory })
+				addFile(entry);
+		}
+		else
+		{
+			for (const auto& entry : std::filesystem::directory_iterator{ directory })
+				addFile(entry);
+		}
+
+		std::sort(iniFilePaths.begin(), iniFilePaths.end());
+		return Load(iniFilePaths);
+	}
+
+	IniLoadResult IniLoader::LoadFile(const std::filesystem::path& iniFilePath) const
+	{
+		IniLoadResult result{};
+		result.iniFilePath = iniFilePath;
+
+		try
+		{
+			IniParser iniParser;
+			iniParser.SetParseMode(parseMode);
+			// The files are already spread over the threads
+			iniParser.SetThreadsCount(1);
+			iniParser.Parse(iniFilePath);
+
+			result.iniSettings = iniParser.GetIniSettings();
+		}
+		catch (const IniSettingValueCastError& error)
+		{
+			result.error = std::current_exception();
+			result.errMsg = error.what();
+		}
+		catch (const IniSettingOptionNotFoundError& error)
+		{
+			result.error = std::current_exception();
+			result.errMsg = error.what();
+		}
+		catch (const std::exception& error)
+		{
+			result.error = std::current_exception();
+			result.errMsg = error.what();
+		}
+		catch (...)
+		{
+			result.error = std::current_exception();
+			result.errMsg = "Unknown error while loading an ini file!";
+		}
+
+		return result;
+	}
+}
\ No newline at end of file
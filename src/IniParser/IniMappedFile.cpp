@@ -0,0 +1,133 @@
+#include "../../include/IniParser/IniMappedFile.h"
+
+#include <cassert>
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define INI_PARSER_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace inip
+{
+	IniMappedFile::IniMappedFile(const std::filesystem::path& filePath)
+	{
+		Open(filePath);
+	}
+	IniMappedFile::~IniMappedFile()
+	{
+		Close();
+	}
+
+	IniMappedFile::IniMappedFile(IniMappedFile&& other) noexcept
+		: mappedData(std::exchange(other.mappedData, nullptr)),
+		mappedSize(std::exchange(other.mappedSize, 0)),
+		readContents(std::move(other.readContents))
+	{
+	}
+	IniMappedFile& IniMappedFile::operator=(IniMappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			mappedData = std::exchange(other.mappedData, nullptr);
+			mappedSize = std::exchange(other.mappedSize, 0);
+			readContents = std::move(other.readContents);
+		}
+		return *this;
+	}
+
+	void IniMappedFile::Open(const std::filesystem::path& filePath)
+	{
+		assert(!filePath.empty() && "The path to an ini file must not be empty!");
+
+		Close();
+		if (!Map(filePath))
+			Read(filePath);
+	}
+	void IniMappedFile::Close()
+	{
+#if defined(INI_PARSER_POSIX)
+		if (mappedData)
+			munmap(const_cast<char*>(mappedData), mappedSize);
+#endif
+		mappedData = nullptr;
+		mappedSize = 0;
+		readContents.clear();
+	}
+
+	std::string_view IniMappedFile::GetContents() const
+	{
+		if (mappedData)
+			return std::string_view{ mappedData, mappedSize };
+		return readContents;
+	}
+	bool IniMappedFile::IsMapped() const
+	{
+		return mappedData != nullptr;
+	}
+
+	bool IniMappedFile::Map(const std::filesystem::path& filePath)
+	{
+#if defined(INI_PARSER_POSIX)
+		int fd = open(filePath.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw std::ifstream::failure{ "I/O runtime error while openning a file!" };
+		}
+
+		struct stat fileStat{};
+		// Empty and non-regular files can't be mapped
+		if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+
+		std::size_t size = static_cast<std::size_t>(fileStat.st_size);
+		void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if (data == MAP_FAILED)
+			return false;
+
+		// The scanner walks the source front to back
+		madvise(data, size, MADV_SEQUENTIAL);
+
+		mappedData = static_cast<const char*>(data);
+		mappedSize = size;
+		return true;
+#else
+		return false;
+#endif
+	}
+	void IniMappedFile::Read(const std::filesystem::path& filePath)
+	{
+		std::ifstream file{ filePath, std::ios::binary };
+		if (file.fail())
+		{
+			throw std::ifstream::failure{ "I/O runtime error while openning a file!" };
+		}
+
+		// Read the whole file in one go when its size is known up front
+		std::error_code errorCode;
+		std::uintmax_t fileSize = std::filesystem::file_size(filePath, errorCode);
+		if (!errorCode && fileSize != 0)
+		{
+			readContents.resize(static_cast<std::size_t>(fileSize));
+			file.read(readContents.data(), static_cast<std::streamsize>(readContents.size()));
+			readContents.resize(static_cast<std::size_t>(file.gcount()));
+			return;
+		}
+
+		char buffer[4096];
+		while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+		{
+			readContents.append(buffer, static_cast<std::size_t>(file.gcount()));
+		}
+	}
+}
\ No newline at end of file
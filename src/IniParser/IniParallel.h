@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace inip
+{
+	inline unsigned ResolveThreadsCount(unsigned threadsCount)
+	{
+		if (threadsCount != 0)
+			return threadsCount;
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Calls 'function(index)' for every index in [0, count) on up to 'threadsCount' threads,
+	// the calling thread being one of them. Indices are handed out one at a time, so uneven items balance out.
+	// A failing item doesn't stop the others, once all of them are done the exception
+	// of the lowest failing index is rethrown.
+	template <typename Function>
+	void ParallelFor(std::size_t count, unsigned threadsCount, Function&& function)
+	{
+		std::vector<std::exception_ptr> errors(count);
+		std::atomic<std::size_t> next{ 0 };
+
+		auto worker = [&]()
+		{
+			for (std::size_t index = next.fetch_add(1); index < count; index = next.fetch_add(1))
+			{
+				try
+				{
+					function(index);
+				}
+				catch (...)
+				{
+					errors[index] = std::current_exception();
+				}
+			}
+		};
+
+		std::size_t spawnCount = std::min<std::size_t>(ResolveThreadsCount(threadsCount), count);
+		std::vector<std::thread> threads;
+		threads.reserve(spawnCount);
+		try
+		{
+			for (std::size_t thread = 1; thread < spawnCount; thread++)
+			{
+				threads.emplace_back(worker);
+			}
+		}
+		catch (...)
+		{
+			// Couldn't start every thread, the ones that did start and this one do the work
+		}
+
+		worker();
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (const std::exception_ptr& error : errors)
+		{
+			if (error)
+				std::rethrow_exception(error);
+		}
+	}
+}
\ No newline at end of file
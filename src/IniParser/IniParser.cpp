@@ -1,26 +1,51 @@
 #include "../../include/IniParser/IniParser.h"
+#include "../../include/IniParser/IniMappedFile.h"
 
+#include "IniLazyGroupLoader.h"
+#include "IniParallel.h"
+
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <climits>
 #include <fstream>
 #include <sstream>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define INI_PARSER_POSIX
+#include <cerrno>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <io.h>
+#endif
+
 namespace inip
 {
+	namespace
+	{
+		// The clock is only read for instrumented parses
+		std::chrono::steady_clock::time_point Now(const IniParseStats* parseStats)
+		{
+			if (!parseStats)
+				return std::chrono::steady_clock::time_point{};
+			return std::chrono::steady_clock::now();
+		}
+	}
+
 	// IniParserError
 
 	IniParserError::IniParserError(const Token& errorToken, std::string_view errMsg)
-		: std::runtime_error(""),
-		errorToken(errorToken)
+		: std::runtime_error("")
 	{
-		CreateErrorMessage(errMsg);
+		CreateErrorMessage(errorToken, errMsg);
 	}
 
-	const char* IniParserError::what() const
+	const char* IniParserError::what() const noexcept
 	{
 		return errMsg.c_str();
 	}
 
-	void IniParserError::CreateErrorMessage(std::string_view errMsg)
+	void IniParserError::CreateErrorMessage(const Token& errorToken, std::string_view errMsg)
 	{
 		std::stringstream sstream;
 		sstream << "IniParserError error has occurred!\n";
@@ -43,27 +68,147 @@ namespace inip
 		Clear();
 	}
 
-	void IniParser::Parse(const std::filesystem::path& iniFilePath)
+	void IniParser::SetParseMode(IniParseMode parseMode)
+	{
+		this->parseMode = parseMode;
+	}
+	IniParseMode IniParser::GetParseMode() const
+	{
+		return parseMode;
+	}
+
+	void IniParser::SetThreadsCount(unsigned threadsCount)
 	{
-		std::string iniSrc = GetIniFileSrc(iniFilePath);
+		this->threadsCount = threadsCount;
+	}
+	unsigned IniParser::GetThreadsCount() const
+	{
+		return threadsCount;
+	}
+
+	void IniParser::SetSymbolTable(std::shared_ptr<IniSymbolTable> symbolTable)
+	{
+		this->symbolTable = std::move(symbolTable);
+	}
+
+	std::shared_ptr<IniSymbolTable> IniParser::GetSymbolTable() const
+	{
+		return symbolTable;
+	}
+
+	void IniParser::Parse(const std::filesystem::path& iniFilePath, IniParseStats* parseStats)
+	{
+		auto ioBegin = Now(parseStats);
+		auto iniFile = std::make_shared<IniMappedFile>(iniFilePath);
+		auto ioEnd = Now(parseStats);
+
+		// A LAZY parse keeps the file mapped for as long as the settings are alive
 		std::filesystem::path iniFileName = iniFilePath;
+		std::string_view iniSource = iniFile->GetContents();
+		ParseBuffer(iniSource, iniFileName.replace_extension().generic_string(), parseStats, std::move(iniFile));
 
-		Parse(iniSrc, iniFileName.replace_extension().generic_string());
+		if (parseStats)
+		{
+			parseStats->ioTime = ioEnd - ioBegin;
+			parseStats->totalTime += parseStats->ioTime;
+		}
 	}
-	void IniParser::Parse(const std::string& iniSource, const std::string& iniSettingsName)
+	void IniParser::Parse(std::string_view iniSource, const std::string& iniSettingsName, IniParseStats* parseStats)
 	{
-		Clear();
+		ParseBuffer(iniSource, iniSettingsName, parseStats, nullptr);
+	}
+	void IniParser::ParseBuffer(
+		std::string_view iniSource,
+		const std::string& iniSettingsName,
+		IniParseStats* parseStats,
+		std::shared_ptr<const void> sourceOwner)
+	{
+		auto begin = Now(parseStats);
+		BeginParse(iniSettingsName, parseStats);
+		if (parseStats)
+			parseStats->bytesRead = iniSource.size();
+
+		if (parseMode == IniParseMode::PARALLEL)
+			ParseParallel(iniSource);
+		else if (parseMode == IniParseMode::LAZY)
+			ParseLazy(iniSource, std::move(sourceOwner));
+		else
+			ParseSource(iniSource, 0, parseMode == IniParseMode::STREAMING);
 
-		iniSettings = std::make_shared<IniSettings>(iniSettingsName);
+		// Visiting the groups of a LAZY parse would build all of them, the pre-pass counted them instead
+		EndParse(begin, parseMode != IniParseMode::LAZY);
+	}
+
+	void IniParser::ParseStream(
+		std::istream& iniStream,
+		const std::string& iniSettingsName,
+		std::size_t bufferSize,
+		IniParseStats* parseStats)
+	{
+		auto begin = Now(parseStats);
+		BeginParse(iniSettingsName, parseStats);
 
-		iniScanner->Scan(iniSource);
-		tokens = iniScanner->GetTokensPtr();
+		ParseChunked([&iniStream](char* buffer, std::size_t size)
+		{
+			iniStream.read(buffer, static_cast<std::streamsize>(size));
+			if (iniStream.bad())
+			{
+				throw std::ifstream::failure{ "I/O runtime error while reading a stream!" };
+			}
+			return static_cast<std::size_t>(iniStream.gcount());
+		}, bufferSize);
+
+		EndParse(begin, true);
+	}
+	void IniParser::ParseDescriptor(
+		int fileDescriptor,
+		const std::string& iniSettingsName,
+		std::size_t bufferSize,
+		IniParseStats* parseStats)
+	{
+		auto begin = Now(parseStats);
+		BeginParse(iniSettingsName, parseStats);
+
+		ParseChunked([fileDescriptor](char* buffer, std::size_t size)
+		{
+#if defined(INI_PARSER_POSIX)
+			while (true)
+			{
+				ssize_t readCount = ::read(fileDescriptor, buffer, size);
+				if (readCount >= 0)
+					return static_cast<std::size_t>(readCount);
+				if (errno != EINTR)
+					throw std::ifstream::failure{ "I/O runtime error while reading a file descriptor!" };
+			}
+#else
+			int readCount = _read(fileDescriptor, buffer, static_cast<unsigned>(std::min<std::size_t>(size, INT_MAX)));
+			if (readCount < 0)
+				throw std::ifstream::failure{ "I/O runtime error while reading a file descriptor!" };
+			return static_cast<std::size_t>(readCount);
+#endif
+		}, bufferSize);
+
+		EndParse(begin, true);
+	}
+
+	bool IniParser::ParseFileEvents(const std::filesystem::path& iniFilePath, IniEventHandler& eventHandler)
+	{
+		IniMappedFile iniFile{ iniFilePath };
+		return ParseEvents(iniFile.GetContents(), eventHandler);
+	}
+	bool IniParser::ParseEvents(std::string_view iniSource, IniEventHandler& eventHandler)
+	{
+		Clear();
+
+		iniScanner->Begin(iniSource, 0);
+		lookahead[0] = iniScanner->NextToken();
 
 		while (!AtEnd())
 		{
-			std::shared_ptr<IniGroup> iniGroup = Group();
-			iniSettings->AddGroup(iniGroup);
+			if (!GroupEvents(eventHandler))
+				return false;
 		}
+		return true;
 	}
 
 	std::shared_ptr<IniSettings> IniParser::GetIniSettings() const
@@ -76,46 +221,306 @@ namespace inip
 		iniScanner = std::make_unique<IniScanner>();
 	}
 
-	std::string IniParser::GetIniFileSrc(const std::filesystem::path& iniFilePath) const
+	std::shared_ptr<IniSettings> IniParser::CreateSettings(const std::string& iniSettingsName) const
+	{
+		auto iniSettings = std::make_shared<IniSettings>(iniSettingsName);
+		if (symbolTable)
+			iniSettings->SetSymbolTable(symbolTable);
+		return iniSettings;
+	}
+
+	void IniParser::BeginParse(const std::string& iniSettingsName, IniParseStats* parseStats)
+	{
+		Clear();
+
+		if (parseStats)
+			*parseStats = IniParseStats{};
+		this->parseStats = parseStats;
+
+		iniSettings = CreateSettings(iniSettingsName);
+	}
+	void IniParser::EndParse(std::chrono::steady_clock::time_point begin, bool countGroups)
 	{
-		assert(!iniFilePath.empty() && "The path to an ini file must not be empty!");
-		std::ifstream file{ iniFilePath , std::ios::binary };
+		if (!parseStats)
+			return;
+
+		CountSettings(countGroups);
+		parseStats->totalTime = std::chrono::steady_clock::now() - begin;
+		parseStats = nullptr;
+	}
 
-		if (file.fail())
+	void IniParser::ParseSource(std::string_view iniSource, int firstLine, bool streaming)
+	{
+		auto begin = Now(parseStats);
+		if (streaming)
+		{
+			iniScanner->Begin(iniSource, firstLine);
+			lookahead[0] = iniScanner->NextToken();
+			if (parseStats)
+				CountToken(lookahead[0]);
+		}
+		else
 		{
-			throw std::ifstream::failure{ "I/O runtime error while openning a file!" };
+			iniScanner->Scan(iniSource, firstLine);
+			tokens = iniScanner->GetTokensPtr();
+			if (parseStats)
+			{
+				parseStats->scanTime += std::chrono::steady_clock::now() - begin;
+				for (const Token& token : *tokens)
+					CountToken(token);
+			}
 		}
 
-		std::ostringstream ostream{};
-		ostream << file.rdbuf();
+		auto parseBegin = Now(parseStats);
+		while (!AtEnd())
+		{
+			Group();
+		}
 
-		std::string iniSrc = ostream.str();
-		return iniSrc;
+		if (parseStats)
+			parseStats->parseTime += std::chrono::steady_clock::now() - parseBegin;
 	}
+	void IniParser::ParseParallel(std::string_view iniSource)
+	{
+		// Below this size a chunk isn't worth a thread
+		constexpr std::size_t minChunkSize{ 256 * 1024 };
+		// A few chunks per thread even out groups of different sizes
+		constexpr std::size_t chunksPerThread{ 4 };
+
+		unsigned workersCount = ResolveThreadsCount(threadsCount);
+		std::size_t chunkSize = std::max(minChunkSize, iniSource.size() / (workersCount * chunksPerThread));
+
+		auto splitBegin = Now(parseStats);
+		std::vector<IniSourceSpan> chunks;
+		if (iniSource.size() > minChunkSize)
+		{
+			for (const IniSourceSpan& group : IniScanner::SplitAtGroups(iniSource))
+			{
+				if (chunks.empty() || chunks.back().end - chunks.back().begin >= chunkSize)
+					chunks.push_back(group);
+				else
+					chunks.back().end = group.end;
+			}
+		}
+
+		if (chunks.size() < 2)
+		{
+			ParseSource(iniSource, 0, true);
+			return;
+		}
 
-	std::shared_ptr<IniGroup> IniParser::Group()
+		auto parseBegin = Now(parseStats);
+		if (parseStats)
+			parseStats->scanTime += parseBegin - splitBegin;
+
+		// Chunk parsers count into stats of their own, merged once they're done
+		std::vector<IniParseStats> chunksStats(parseStats ? chunks.size() : 0);
+
+		// Every chunk is parsed into settings of its own (and so into an arena of its own),
+		// the groups are then merged in file order without being copied
+		std::vector<std::shared_ptr<IniSettings>> chunksSettings(chunks.size());
+		ParallelFor(chunks.size(), workersCount, [&](std::size_t chunk)
+		{
+			const IniSourceSpan& span = chunks[chunk];
+
+			IniParser chunkParser;
+			chunkParser.iniSettings = CreateSettings(iniSettings->GetIniSettingsName());
+			chunkParser.parseStats = parseStats ? &chunksStats[chunk] : nullptr;
+			chunkParser.ParseSource(iniSource.substr(span.begin, span.end - span.begin), span.line, true);
+
+			chunksSettings[chunk] = chunkParser.iniSettings;
+		});
+
+		for (std::shared_ptr<IniSettings>& chunkSettings : chunksSettings)
+		{
+			if (parseStats)
+			{
+				parseStats->bytesAllocated += chunkSettings->GetArena().GetAllocatedBytes();
+				parseStats->allocationsCount += chunkSettings->GetArena().GetAllocationsCount();
+			}
+			iniSettings->AddGroups(std::move(chunkSettings));
+		}
+
+		if (parseStats)
+		{
+			parseStats->parseTime += std::chrono::steady_clock::now() - parseBegin;
+			for (const IniParseStats& chunkStats : chunksStats)
+			{
+				for (std::size_t tokenType = 0; tokenType < tokenTypesCount; tokenType++)
+					parseStats->tokensCount[tokenType] += chunkStats.tokensCount[tokenType];
+			}
+		}
+	}
+
+	void IniParser::ParseChunked(const ReadFunction& read, std::size_t bufferSize)
 	{
-		std::string groupId = GroupId();
+		std::string buffer(std::max<std::size_t>(bufferSize, 1), '\0');
+		std::size_t filled = 0;
+		bool endOfSource = false;
+		int line = 0;
 
-		std::shared_ptr<IniGroup> iniGroup = std::make_shared<IniGroup>(groupId);
+		while (true)
+		{
+			auto readBegin = Now(parseStats);
+			while (!endOfSource && filled < buffer.size())
+			{
+				std::size_t readCount = read(buffer.data() + filled, buffer.size() - filled);
+				endOfSource = readCount == 0;
+				filled += readCount;
+				if (parseStats)
+					parseStats->bytesRead += readCount;
+			}
+
+			auto scanBegin = Now(parseStats);
+			std::string_view chunk{ buffer.data(), filled };
+			std::size_t scannedEnd = filled;
+			iniScanner->Clear();
+			if (endOfSource)
+				iniScanner->Scan(chunk, line);
+			else
+				scannedEnd = iniScanner->ScanPrefix(chunk, line);
+			tokens = iniScanner->GetTokensPtr();
+			current = 0;
+
+			// The last statement may be cut short, it's kept with whatever wasn't scanned until the next chunk completes it.
+			// Without a whole statement in the chunk, only the comments in front of it are dropped.
+			std::size_t keepFrom = filled;
+			if (!endOfSource)
+			{
+				std::size_t lastStatement = LastStatementBegin();
+				if (!tokens->empty())
+				{
+					const Token& next = (*tokens)[lastStatement];
+					keepFrom = static_cast<std::size_t>(next.literal.data() - buffer.data());
+					line = next.line;
+				}
+				else
+				{
+					keepFrom = scannedEnd;
+					line += static_cast<int>(std::count(buffer.begin(), buffer.begin() + keepFrom, '\n'));
+				}
+
+				Token endOfChunk{};
+				endOfChunk.type = TokenType::END_OF_FILE;
+				endOfChunk.line = line;
+				tokens->resize(lastStatement);
+				tokens->push_back(endOfChunk);
+			}
+
+			if (parseStats)
+			{
+				parseStats->ioTime += scanBegin - readBegin;
+				parseStats->scanTime += std::chrono::steady_clock::now() - scanBegin;
+
+				// END_OF_FILE is only counted at the end of the source
+				std::size_t tokensCount = endOfSource ? tokens->size() : tokens->size() - 1;
+				for (std::size_t token = 0; token < tokensCount; token++)
+					CountToken((*tokens)[token]);
+			}
+
+			auto parseBegin = Now(parseStats);
+			ParseStatements();
+			if (parseStats)
+				parseStats->parseTime += std::chrono::steady_clock::now() - parseBegin;
+
+			if (endOfSource)
+				break;
+
+			if (keepFrom == 0)
+			{
+				// A single statement fills the whole buffer, it grows to make room for the rest of it
+				buffer.resize(buffer.size() * 2);
+				continue;
+			}
+
+			// What's kept moves to the front and the rest of the buffer is refilled
+			std::copy(buffer.begin() + keepFrom, buffer.begin() + filled, buffer.begin());
+			filled -= keepFrom;
+		}
 
-		while (Peek().type == TokenType::IDENTIFIER)
+		iniScanner->Clear();
+		tokens = nullptr;
+	}
+
+	void IniParser::ParseStatements()
+	{
+		while (!AtEnd())
+		{
+			if (currentGroup && Peek().type == TokenType::IDENTIFIER)
+				Option(*currentGroup);
+			else
+				currentGroup = &Group();
+		}
+	}
+	std::size_t IniParser::LastStatementBegin() const
+	{
+		// A value is never followed by a '=', so "IDENTIFIER =" always begins an option
+		for (std::size_t token = tokens->size(); token-- > 1;)
+		{
+			TokenType type = (*tokens)[token].type;
+			if (type == TokenType::LEFT_SQUARE_BRACKET)
+				return token;
+			if (type == TokenType::IDENTIFIER && token + 1 < tokens->size() && (*tokens)[token + 1].type == TokenType::EQUAL)
+				return token;
+		}
+		return 0;
+	}
+
+	void IniParser::ParseLazy(std::string_view iniSource, std::shared_ptr<const void> sourceOwner)
+	{
+		// The groups are parsed long after the caller's buffer may be gone
+		if (!sourceOwner)
+		{
+			auto ownedSource = std::make_shared<const std::string>(iniSource);
+			iniSource = *ownedSource;
+			sourceOwner = std::move(ownedSource);
+		}
+
+		auto begin = Now(parseStats);
+		auto groupLoader = std::make_shared<IniLazyGroupLoader>(
+			iniSource, std::move(sourceOwner), iniSettings->GetIniSettingsName(), symbolTable);
+
+		if (parseStats)
 		{
-			std::shared_ptr<IniOption> iniOption = Option();
-			iniGroup->AddOption(iniOption);
+			parseStats->scanTime += std::chrono::steady_clock::now() - begin;
+			parseStats->groupsCount = groupLoader->GetGroupsCount();
 		}
+		iniSettings->SetGroupLoader(std::move(groupLoader));
+	}
+
+	bool IniParser::ScanGroupHeader(std::string_view iniSource, int firstLine, std::string_view& groupName)
+	{
+		Clear();
+
+		iniScanner->Begin(iniSource, firstLine);
+		lookahead[0] = iniScanner->NextToken();
+		if (AtEnd())
+			return false;
+
+		groupName = GroupId();
+		return true;
+	}
+
+	IniGroup& IniParser::Group()
+	{
+		std::string_view groupId = GroupId();
+
+		IniGroup& iniGroup = iniSettings->CreateGroup(groupId);
 
+		while (Peek().type == TokenType::IDENTIFIER)
+		{
+			Option(iniGroup);
+		}
 		return iniGroup;
 	}
-	std::string IniParser::GroupId()
+	std::string_view IniParser::GroupId()
 	{
-		Token leftSquareBracket =
-			Consume(
-				TokenType::LEFT_SQUARE_BRACKET,
-				"Group ID is expected to begin with a '[' symbol!");
+		Consume(
+			TokenType::LEFT_SQUARE_BRACKET,
+			"Group ID is expected to begin with a '[' symbol!");
 
-		std::string groupId{};
-		Token idStr = Advance();
+		std::string_view groupId{};
+		const Token& idStr = Advance();
 		if (idStr.type == TokenType::IDENTIFIER)
 		{
 			groupId = idStr.literal;
@@ -129,73 +534,232 @@ namespace inip
 			throw IniParserError(Peek(), "Unexpected Group ID! It must be either [IDENTIFIER] or [STRING]!");
 		}
 
-		Token rightSquareBracket =
-			Consume(
-				TokenType::RIGHT_SQUARE_BRACKET,
-				"Group ID is expected to end with a ']' symbol!");
+		Consume(
+			TokenType::RIGHT_SQUARE_BRACKET,
+			"Group ID is expected to end with a ']' symbol!");
 
 		return groupId;
 	}
-	std::shared_ptr<IniOption> IniParser::Option()
+	void IniParser::Option(IniGroup& iniGroup)
 	{
-		std::shared_ptr<IniOption> iniOption{};
-
-		Token optionKey =
+		const Token& optionKey =
 			Consume(
 				TokenType::IDENTIFIER,
 				"An option's key is expected to be an IDENTIFIER!");
 
-		Token equalSign =
+		Consume(
+			TokenType::EQUAL,
+			"Expected to delimit an option's 'key' and 'value' with a '=' sign!");
+
+		// Tokens only hold views into the source, the strings are materialized in the settings' arena
+		const Token& value = Advance();
+		if (Check(TokenType::COMMA))
+		{
+			CreateListOption(iniGroup, optionKey.literal, value);
+			return;
+		}
+
+		try
+		{
+			CreateOption(iniGroup, optionKey, value);
+		}
+		catch (const IniSettingValueCastError&)
+		{
+			throw IniParserError(Previous(), "The value doesn't fit into its numeric type!");
+		}
+	}
+	void IniParser::CreateOption(IniGroup& iniGroup, const Token& optionKey, const Token& value)
+	{
+		std::string_view valueText{};
+		IniOptionType optionType = OptionValue(value, valueText);
+		iniGroup.CreateOption(optionKey.literal, valueText, optionType);
+	}
+	void IniParser::CreateListOption(IniGroup& iniGroup, std::string_view optionKey, const Token& firstValue)
+	{
+		ListElements(firstValue);
+		try
+		{
+			iniGroup.CreateListOption(optionKey, listElements);
+		}
+		catch (const IniSettingValueCastError&)
+		{
+			throw IniParserError(listTokens[FailingListElement()], "The value doesn't fit into its numeric type!");
+		}
+	}
+	void IniParser::ListElements(const Token& firstValue)
+	{
+		listElements.clear();
+		listTokens.clear();
+
+		IniListElement element{};
+		element.elementType = OptionValue(firstValue, element.text);
+		listElements.push_back(element);
+		listTokens.push_back(firstValue);
+
+		while (Check(TokenType::COMMA))
+		{
+			Advance();
+			const Token& value = Advance();
+			element.elementType = OptionValue(value, element.text);
+			listElements.push_back(element);
+			listTokens.push_back(value);
+		}
+	}
+	std::size_t IniParser::FailingListElement() const
+	{
+		for (std::size_t element = 0; element < listElements.size(); element++)
+		{
+			std::string_view text = listElements[element].text;
+			std::from_chars_result result{ text.data(), std::errc{} };
+			if (listElements[element].elementType == IniOptionType::INTEGER)
+			{
+				long long integer{};
+				result = std::from_chars(text.data(), text.data() + text.size(), integer);
+			}
+			else if (listElements[element].elementType == IniOptionType::FLOAT)
+			{
+				double number{};
+				result = std::from_chars(text.data(), text.data() + text.size(), number);
+			}
+			else
+			{
+				continue;
+			}
+
+			if (result.ec != std::errc{} || result.ptr != text.data() + text.size())
+				return element;
+		}
+		return listElements.size() - 1;
+	}
+
+	bool IniParser::GroupEvents(IniEventHandler& eventHandler)
+	{
+		int line = Peek().line;
+		std::string_view groupId = GroupId();
+
+		if (!eventHandler.OnGroupBegin(groupId, line))
+			return false;
+
+		while (Peek().type == TokenType::IDENTIFIER)
+		{
+			if (!OptionEvent(eventHandler))
+				return false;
+		}
+
+		return eventHandler.OnGroupEnd(groupId);
+	}
+	bool IniParser::OptionEvent(IniEventHandler& eventHandler)
+	{
+		const Token& optionKey =
 			Consume(
-				TokenType::EQUAL,
-				"Expected to delimit an option's 'key' and 'value' with a '=' sign!");
+				TokenType::IDENTIFIER,
+				"An option's key is expected to be an IDENTIFIER!");
+
+		// The key's token is overwritten in the streaming window by the elements of a list
+		std::string_view key = optionKey.literal;
+		int line = optionKey.line;
 
-		Token value = Advance();
+		Consume(
+			TokenType::EQUAL,
+			"Expected to delimit an option's 'key' and 'value' with a '=' sign!");
+
+		const Token& value = Advance();
+
+		std::string_view valueText{};
+		IniOptionType optionType = OptionValue(value, valueText);
+
+		// A list is reported as the text it spans in the source, quotes of its STRING elements included
+		if (Check(TokenType::COMMA))
+		{
+			const char* listBegin = value.literal.data();
+			ListElements(value);
+
+			const Token& lastValue = Previous();
+			valueText = std::string_view{
+				listBegin,
+				static_cast<std::size_t>(lastValue.literal.data() + lastValue.literal.size() - listBegin) };
+			optionType = IniOptionType::LIST;
+		}
+
+		return eventHandler.OnOption(key, valueText, optionType, line);
+	}
+
+	IniOptionType IniParser::OptionValue(const Token& value, std::string_view& valueText) const
+	{
 		switch (value.type)
 		{
 		case TokenType::STRING:
-			iniOption = std::make_shared<IniOption>(optionKey.literal, value.value, IniOptionType::STRING);
-			break;
+			valueText = value.value;
+			return IniOptionType::STRING;
 		case TokenType::INTEGER:
-			iniOption = std::make_shared<IniOption>(optionKey.literal, value.literal, IniOptionType::INTEGER);
-			break;
+			valueText = value.literal;
+			return IniOptionType::INTEGER;
 		case TokenType::FLOAT:
-			iniOption = std::make_shared<IniOption>(optionKey.literal, value.literal, IniOptionType::FLOAT);
-			break;
+			valueText = value.literal;
+			return IniOptionType::FLOAT;
 		case TokenType::IDENTIFIER:
-			iniOption = std::make_shared<IniOption>(optionKey.literal, value.literal, IniOptionType::STRING);
-			break;
+			valueText = value.literal;
+			return IniOptionType::STRING;
 		default:
 			throw IniParserError(Peek(), "Unexpected 'value' token! Must be either STRING, INTEGER, FLOAT or IDENTIFIER!");
 		}
-
-		return iniOption;
 	}
 
-	Token IniParser::Advance()
+	const Token& IniParser::Advance()
 	{
 		if (AtEnd())
 			return Peek();
 		current++;
+		if (!tokens)
+		{
+			lookahead[current % lookaheadSize] = iniScanner->NextToken();
+			if (parseStats)
+				CountToken(lookahead[current % lookaheadSize]);
+		}
 		return Previous();
 	}
-	Token IniParser::Peek() const
+	const Token& IniParser::Peek() const
 	{
-		return (*tokens)[current];
+		return TokenAt(current);
 	}
-	Token IniParser::Previous() const
+	const Token& IniParser::Previous() const
 	{
 		assert(current != 0 &&
 			"Cannot call 'Previous' while at the beginning of the stream!");
-		return (*tokens)[current - 1];
+		return TokenAt(current - 1);
 	}
-	Token IniParser::Consume(TokenType type, std::string_view errMsg)
+	const Token& IniParser::Consume(TokenType type, std::string_view errMsg)
 	{
 		if (Check(type))
 			return Advance();
 		throw IniParserError(Peek(), errMsg);
 	}
 
+	void IniParser::CountToken(const Token& token)
+	{
+		parseStats->tokensCount[static_cast<std::size_t>(token.type)]++;
+	}
+	void IniParser::CountSettings(bool countGroups)
+	{
+		if (countGroups)
+		{
+			parseStats->groupsCount = 0;
+			parseStats->optionsCount = 0;
+			iniSettings->ForEachGroup([this](const IniGroup& iniGroup)
+			{
+				parseStats->groupsCount++;
+				iniGroup.ForEachOption([this](const IniOption&)
+				{
+					parseStats->optionsCount++;
+				});
+			});
+		}
+
+		// The chunks' arenas of a PARALLEL parse were counted as they were merged
+		parseStats->bytesAllocated += iniSettings->GetArena().GetAllocatedBytes();
+		parseStats->allocationsCount += iniSettings->GetArena().GetAllocationsCount();
+	}
+
 	bool IniParser::Check(TokenType type)
 	{
 		if (AtEnd())
@@ -209,11 +773,20 @@ namespace inip
 		return false;
 	}
 
+	const Token& IniParser::TokenAt(int index) const
+	{
+		if (!tokens)
+			return lookahead[index % lookaheadSize];
+		return (*tokens)[index];
+	}
+
 	void IniParser::Clear()
 	{
 		iniScanner->Clear();
 		current = 0;
 		tokens = nullptr;
 		iniSettings.reset();
+		currentGroup = nullptr;
+		parseStats = nullptr;
 	}
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ namespace inip
 		{ TokenType::RIGHT_SQUARE_BRACKET, "RIGHT_SQUARE_BRACKET" },
 
 		{ TokenType::EQUAL, "EQUAL" },
+		{ TokenType::COMMA, "COMMA" },
 
 		{ TokenType::IDENTIFIER, "IDENTIFIER" },
 		{ TokenType::STRING, "STRING" },
@@ -37,7 +38,7 @@ namespace inip
 		CreateErrorMessage(errMsg);
 	}
 
-	const char* IniScannerError::what() const
+	const char* IniScannerError::what() const noexcept
 	{
 		return errMsg.c_str();
 	}
@@ -54,24 +55,177 @@ namespace inip
 
 	// IniScanner
 
-	void IniScanner::Scan(const std::string& iniSource)
+	void IniScanner::Scan(std::string_view iniSource, int firstLine)
 	{
 		this->iniSource = iniSource;
+		structuralIndex.Reset(iniSource);
+		line = firstLine;
 		while (!AtEnd())
 		{
 			BeginToken();
-			ScanToken();
+
+			Token token{};
+			if (ScanToken(token))
+				tokens.push_back(token);
 		}
 
-		Token eof_token{};
-		eof_token.type = TokenType::END_OF_FILE;
+		tokens.push_back(MakeEndOfFileToken());
+	}
+
+	std::size_t IniScanner::ScanPrefix(std::string_view iniSource, int firstLine)
+	{
+		Clear();
+		this->iniSource = iniSource;
+		structuralIndex.Reset(iniSource);
+		line = firstLine;
+
+		scanningPrefix = true;
+		try
+		{
+			while (!AtEnd())
+			{
+				BeginToken();
 
-		tokens.push_back(eof_token);
+				Token token{};
+				if (ScanToken(token))
+					tokens.push_back(token);
+			}
+		}
+		catch (const PrefixEnd&)
+		{
+			scanningPrefix = false;
+			return start;
+		}
+		catch (const IniScannerError&)
+		{
+			scanningPrefix = false;
+
+			// Anything but a string or a comment ends on its line,
+			// so an error before the last line stays an error once the rest is read
+			if (iniSource.find('\n', start) != std::string_view::npos)
+				throw;
+			return start;
+		}
+
+		scanningPrefix = false;
+		return current;
+	}
+
+	void IniScanner::Begin(std::string_view iniSource, int firstLine)
+	{
+		Clear();
+		this->iniSource = iniSource;
+		structuralIndex.Reset(iniSource);
+		line = firstLine;
+	}
+	Token IniScanner::NextToken()
+	{
+		Token token{};
+		while (!AtEnd())
+		{
+			BeginToken();
+			if (ScanToken(token))
+				return token;
+		}
+		return MakeEndOfFileToken();
 	}
+	std::vector<IniSourceSpan> IniScanner::SplitAtGroups(std::string_view iniSource)
+	{
+		// Every character that matters here ('[', '"', '/', '*', '\n') is structural,
+		// so the pre-pass only visits the set bits of the structural index.
+		// Malformed input is left for the scanner to report.
+
+		std::vector<IniSourceSpan> groups;
+
+		IniStructuralIndex index;
+		index.Reset(iniSource);
+
+		std::size_t size = iniSource.size();
+		std::size_t position = 0;
+		int line = 0;
+
+		while ((position = index.NextStructural(position)) < size)
+		{
+			char c = iniSource[position++];
+			switch (c)
+			{
+			case '\n':
+			{
+				line++;
+			}
+			break;
+
+			case '[':
+			{
+				groups.push_back(IniSourceSpan{ position - 1, size, line });
+			}
+			break;
+
+			case '"':
+			{
+				while ((position = index.NextStructural(position)) < size)
+				{
+					char s = iniSource[position++];
+					if (s == '\n')
+						line++;
+					else if (s == '"')
+						break;
+				}
+			}
+			break;
+
+			case '/':
+			{
+				if (position < size && iniSource[position] == '/')
+				{
+					// The newline that ends the comment is counted by the main loop
+					position++;
+					while ((position = index.NextStructural(position)) < size && iniSource[position] != '\n')
+						position++;
+				}
+				else if (position < size && iniSource[position] == '*')
+				{
+					position++;
+					while ((position = index.NextStructural(position)) < size)
+					{
+						char s = iniSource[position++];
+						if (s == '\n')
+						{
+							line++;
+						}
+						else if (s == '*' && position < size && iniSource[position] == '/')
+						{
+							position++;
+							break;
+						}
+					}
+				}
+			}
+			break;
+			}
+		}
+
+		if (groups.empty())
+			return { IniSourceSpan{ 0, size, 0 } };
+
+		for (std::size_t group = 0; group + 1 < groups.size(); group++)
+		{
+			groups[group].end = groups[group + 1].begin;
+		}
+
+		// The first group also takes whatever comes before it
+		groups.front().begin = 0;
+		groups.front().line = 0;
+
+		return groups;
+	}
+
 	void IniScanner::Clear()
 	{
-		iniSource.clear();
+		iniSource = std::string_view{};
+		structuralIndex.Reset(iniSource);
 		current = 0;
+		start = 0;
 		line = 0;
 		tokens.clear();
 	}
@@ -81,27 +235,32 @@ namespace inip
 		return &tokens;
 	}
 
-	void IniScanner::ScanToken()
+	bool IniScanner::ScanToken(Token& token)
 	{
 		char c = Advance();
 		switch (c)
 		{
 		case '=':
 		{
-			AddToken(TokenType::EQUAL);
+			token = MakeToken(TokenType::EQUAL);
 		}
-		break;
+		return true;
+		case ',':
+		{
+			token = MakeToken(TokenType::COMMA);
+		}
+		return true;
 
 		case '[':
 		{
-			AddToken(TokenType::LEFT_SQUARE_BRACKET);
+			token = MakeToken(TokenType::LEFT_SQUARE_BRACKET);
 		}
-		break;
+		return true;
 		case ']':
 		{
-			AddToken(TokenType::RIGHT_SQUARE_BRACKET);
+			token = MakeToken(TokenType::RIGHT_SQUARE_BRACKET);
 		}
-		break;
+		return true;
 
 		// Comments
 		case '/':
@@ -109,30 +268,12 @@ namespace inip
 			// Single line comment
 			if (Match('/'))
 			{
-				while (!AtEnd() && Peek() != '\n')
-					Advance();
+				LineComment();
 			}
 			// Multi line comment
 			else if (Match('*'))
 			{
-				while (!AtEnd())
-				{
-					if (Peek() == '*' && PeekNext() == '/')
-					{
-						Advance(); Advance();
-						break;
-					}
-
-					if (Match('\n'))
-					{
-						line++;
-					}
-				}
-
-				if (AtEnd())
-				{
-					throw IniScannerError{ "Unterminated multi line comment!", line };
-				}
+				MultiLineComment();
 			}
 			else
 			{
@@ -155,47 +296,48 @@ namespace inip
 
 		case '\0':
 		{
-			AddToken(TokenType::END_OF_FILE);
+			token = MakeToken(TokenType::END_OF_FILE);
 		}
-		break;
+		return true;
 
 		case '"':
 		{
-			String();
+			token = String();
 		}
-		break;
+		return true;
 
 		default:
 		{
 			if (IsDigit(c))
 			{
-				Number();
+				token = Number();
 			}
 			else if (IsAlpha(c))
 			{
-				Identifier();
+				token = Identifier();
 			}
 			else
 			{
 				throw IniScannerError{ "Unexpected symbol!", line };
 			}
 		}
-		break;
+		return true;
 		}
+
+		return false;
 	}
 
 	void IniScanner::BeginToken()
 	{
 		start = current;
 	}
-	void IniScanner::AddToken(TokenType type)
+	Token IniScanner::MakeToken(TokenType type)
 	{
-		int charsCount = current - start;
-		std::string literal = iniSource.substr(start, charsCount);
+		std::size_t charsCount = current - start;
 
 		Token token{};
 		token.type = type;
-		token.literal = literal;
+		token.literal = iniSource.substr(start, charsCount);
 		token.line = line;
 
 		if (type == TokenType::STRING)
@@ -203,12 +345,19 @@ namespace inip
 			token.value = iniSource.substr(start + 1, charsCount - 2);
 		}
 
-		tokens.push_back(token);
+		return token;
+	}
+	Token IniScanner::MakeEndOfFileToken()
+	{
+		Token eofToken{};
+		eofToken.type = TokenType::END_OF_FILE;
+		eofToken.line = line;
+		return eofToken;
 	}
 
 	char IniScanner::Advance()
 	{
-		return iniSource.at(current++);
+		return iniSource[current++];
 	}
 	bool IniScanner::Match(char expected)
 	{
@@ -228,19 +377,65 @@ namespace inip
 	{
 		if (AtEnd())
 			return '\0';
-		return iniSource.at(current);
+		return iniSource[current];
 	}
 	char IniScanner::PeekNext()
 	{
 		if (current + 1 >= iniSource.size())
 			return '\0';
-		return iniSource.at(current + 1);
+		return iniSource[current + 1];
+	}
+
+	void IniScanner::SkipToStructural()
+	{
+		// Comment and string bodies carry no tokens, so jump straight to
+		// the next character that can end them or change the line counter
+		current = structuralIndex.NextStructural(current);
+	}
+
+	void IniScanner::LineComment()
+	{
+		while (true)
+		{
+			SkipToStructural();
+			if (AtEnd() && scanningPrefix)
+				throw PrefixEnd{};
+			if (AtEnd() || Peek() == '\n')
+				break;
+			Advance();
+		}
+	}
+	void IniScanner::MultiLineComment()
+	{
+		while (true)
+		{
+			SkipToStructural();
+			if (AtEnd())
+			{
+				if (scanningPrefix)
+					throw PrefixEnd{};
+				throw IniScannerError{ "Unterminated multi line comment!", line };
+			}
+
+			char c = Advance();
+			if (c == '\n')
+			{
+				line++;
+			}
+			else if (c == '*' && Match('/'))
+			{
+				break;
+			}
+		}
 	}
 
-	void IniScanner::String()
+	Token IniScanner::String()
 	{
-		while (!AtEnd() && Peek() != '"')
+		while (true)
 		{
+			SkipToStructural();
+			if (AtEnd() || Peek() == '"')
+				break;
 			if (Peek() == '\n')
 				line++;
 			Advance();
@@ -248,13 +443,15 @@ namespace inip
 
 		if (AtEnd())
 		{
+			if (scanningPrefix)
+				throw PrefixEnd{};
 			throw IniScannerError{ "Forgot to close the string with a \"!", line };
 		}
 
 		Advance();
-		AddToken(TokenType::STRING);
+		return MakeToken(TokenType::STRING);
 	}
-	void IniScanner::Number()
+	Token IniScanner::Number()
 	{
 		// It's either integer or floating point number
 		// For both types we're going to use the biggest types in their class:
@@ -272,14 +469,14 @@ namespace inip
 			{
 				Advance();
 			}
-			AddToken(TokenType::FLOAT);
+			return MakeToken(TokenType::FLOAT);
 		}
 		else
 		{
-			AddToken(TokenType::INTEGER);
+			return MakeToken(TokenType::INTEGER);
 		}
 	}
-	void IniScanner::Identifier()
+	Token IniScanner::Identifier()
 	{
 		// !AtEnd() is redundant
 		while (IsAlphaNumeric(Peek()))
@@ -287,7 +484,7 @@ namespace inip
 			Advance();
 		}
 
-		AddToken(TokenType::IDENTIFIER);
+		return MakeToken(TokenType::IDENTIFIER);
 	}
 
 	bool IniScanner::IsAlpha(char c) const
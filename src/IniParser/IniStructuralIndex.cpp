@@ -0,0 +1,217 @@
+#include "../../include/IniParser/IniStructuralIndex.h"
+
+#include <algorithm>
+#include <array>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define INI_PARSER_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace inip
+{
+	namespace
+	{
+		using ClassifyBlockFn = std::uint64_t(*)(const char* block);
+
+		constexpr std::array<bool, 256> MakeStructuralTable()
+		{
+			std::array<bool, 256> table{};
+			for (unsigned char c : { '[', ']', '=', '"', '\n', '/', '*' })
+				table[c] = true;
+			return table;
+		}
+
+		constexpr std::array<bool, 256> structuralTable = MakeStructuralTable();
+
+		std::uint64_t ClassifyScalar(const char* block, std::size_t size)
+		{
+			std::uint64_t bits{ 0 };
+			for (std::size_t i = 0; i < size; i++)
+			{
+				if (structuralTable[static_cast<unsigned char>(block[i])])
+					bits |= std::uint64_t{ 1 } << i;
+			}
+			return bits;
+		}
+
+#if !defined(INI_PARSER_X86_64)
+		std::uint64_t ClassifyBlockScalar(const char* block)
+		{
+			return ClassifyScalar(block, 64);
+		}
+#endif
+
+		unsigned CountTrailingZeros(std::uint64_t bits)
+		{
+#if defined(_MSC_VER) && defined(INI_PARSER_X86_64)
+			unsigned long index{ 0 };
+			_BitScanForward64(&index, bits);
+			return static_cast<unsigned>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+			unsigned index{ 0 };
+			while ((bits & 1) == 0)
+			{
+				bits >>= 1;
+				index++;
+			}
+			return index;
+#endif
+		}
+
+#if defined(INI_PARSER_X86_64)
+
+		// SSE2 is part of the x86-64 baseline, so it needs no runtime check
+
+		std::uint64_t ClassifyBlockSse2(const char* block)
+		{
+			std::uint64_t bits{ 0 };
+			for (int i = 0; i < 4; i++)
+			{
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+
+				__m128i mask = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('['));
+				mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']')));
+				mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('=')));
+				mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+				mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+				mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('/')));
+				mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('*')));
+
+				std::uint64_t chunkBits = static_cast<std::uint32_t>(_mm_movemask_epi8(mask));
+				bits |= chunkBits << (i * 16);
+			}
+			return bits;
+		}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define INI_PARSER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define INI_PARSER_TARGET_AVX2
+#endif
+
+		INI_PARSER_TARGET_AVX2 std::uint64_t ClassifyBlockAvx2(const char* block)
+		{
+			std::uint64_t bits{ 0 };
+			for (int i = 0; i < 2; i++)
+			{
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * 32));
+
+				__m256i mask = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('['));
+				mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(']')));
+				mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('=')));
+				mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')));
+				mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n')));
+				mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('/')));
+				mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('*')));
+
+				std::uint64_t chunkBits = static_cast<std::uint32_t>(_mm256_movemask_epi8(mask));
+				bits |= chunkBits << (i * 32);
+			}
+			return bits;
+		}
+
+		bool CpuSupportsAvx2()
+		{
+#if defined(_MSC_VER)
+			int info[4]{};
+			__cpuid(info, 1);
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx)
+				return false;
+			// The OS has to save the YMM registers on context switches
+			if ((_xgetbv(0) & 0x6) != 0x6)
+				return false;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#else
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+
+#endif
+
+		ClassifyBlockFn SelectClassifyBlock()
+		{
+#if defined(INI_PARSER_X86_64)
+			if (CpuSupportsAvx2())
+				return ClassifyBlockAvx2;
+			return ClassifyBlockSse2;
+#else
+			return ClassifyBlockScalar;
+#endif
+		}
+
+		// Selected on first use, a parse may run while other translation units are statically initialized
+		ClassifyBlockFn ClassifyBlock()
+		{
+			static const ClassifyBlockFn classifyBlock = SelectClassifyBlock();
+			return classifyBlock;
+		}
+	}
+
+	// IniStructuralIndex
+
+	void IniStructuralIndex::Reset(std::string_view source)
+	{
+		this->source = source;
+		windowBegin = 0;
+		windowEnd = 0;
+	}
+
+	std::size_t IniStructuralIndex::NextStructural(std::size_t position)
+	{
+		while (position < source.size())
+		{
+			if (position < windowBegin || position >= windowEnd)
+				IndexWindow(position - position % blockSize);
+
+			std::size_t offset = position - windowBegin;
+			std::size_t block = offset / blockSize;
+			std::size_t blocksCount = (windowEnd - windowBegin + blockSize - 1) / blockSize;
+
+			// Discard the characters before 'position' in its own block
+			std::uint64_t mask = bits[block] & (~std::uint64_t{ 0 } << (offset % blockSize));
+			while (true)
+			{
+				if (mask != 0)
+					return windowBegin + block * blockSize + CountTrailingZeros(mask);
+				if (++block == blocksCount)
+					break;
+				mask = bits[block];
+			}
+
+			position = windowEnd;
+		}
+		return source.size();
+	}
+
+	void IniStructuralIndex::IndexWindow(std::size_t windowBegin)
+	{
+		this->windowBegin = windowBegin;
+		windowEnd = std::min(windowBegin + windowBlocks * blockSize, source.size());
+
+		const char* data = source.data() + windowBegin;
+		std::size_t size = windowEnd - windowBegin;
+		std::size_t fullBlocks = size / blockSize;
+
+		ClassifyBlockFn classifyBlock = ClassifyBlock();
+		for (std::size_t block = 0; block < fullBlocks; block++)
+		{
+			bits[block] = classifyBlock(data + block * blockSize);
+		}
+
+		std::size_t tail = size % blockSize;
+		if (tail != 0)
+		{
+			bits[fullBlocks] = ClassifyScalar(data + fullBlocks * blockSize, tail);
+		}
+	}
+}
\ No newline at end of file
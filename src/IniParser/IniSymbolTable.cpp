@@ -0,0 +1,104 @@
+#include "../../include/IniParser/IniSymbolTable.h"
+
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+namespace inip
+{
+	// IniSymbolTable
+
+	IniSymbolTable::IniSymbolTable()
+	{
+	}
+
+	IniSymbol IniSymbolTable::Intern(std::string_view name)
+	{
+		std::uint64_t hash = HashKey(name);
+		{
+			std::shared_lock<std::shared_mutex> lock{ mutex };
+			if (const IniSymbol* symbol = symbolsByName.Find(name, hash))
+				return *symbol;
+		}
+
+		std::unique_lock<std::shared_mutex> lock{ mutex };
+		if (const IniSymbol* symbol = symbolsByName.Find(name, hash))
+			return *symbol;
+
+		char* text = static_cast<char*>(names.allocate(name.size() + 1, 1));
+		std::memcpy(text, name.data(), name.size());
+		text[name.size()] = '\0';
+
+		const IniSymbol& symbol = symbols.emplace_back(
+			static_cast<IniSymbolId>(symbols.size()), std::string_view{ text, name.size() }, hash);
+		symbolsByName.Insert(symbol.GetName(), hash, &symbol);
+		return symbol;
+	}
+
+	IniSymbol IniSymbolTable::GetSymbol(IniSymbolId id) const
+	{
+		std::shared_lock<std::shared_mutex> lock{ mutex };
+		return symbols[id];
+	}
+	std::size_t IniSymbolTable::GetSymbolsCount() const
+	{
+		std::shared_lock<std::shared_mutex> lock{ mutex };
+		return symbols.size();
+	}
+
+	// IniName
+
+	IniName::IniName(std::string_view text, std::pmr::memory_resource* resource)
+		: size(static_cast<std::uint32_t>(text.size())),
+		resource(resource)
+	{
+		char* ownText = static_cast<char*>(resource->allocate(text.size() + 1, 1));
+		std::memcpy(ownText, text.data(), text.size());
+		ownText[text.size()] = '\0';
+		this->text = ownText;
+	}
+	IniName::IniName(const IniSymbol& symbol)
+		: text(symbol.GetName().data()),
+		size(static_cast<std::uint32_t>(symbol.GetName().size())),
+		symbolId(symbol.GetId())
+	{
+	}
+
+	IniName::IniName(const IniName& other)
+		: IniName(other.GetText(), std::pmr::get_default_resource())
+	{
+	}
+	IniName::IniName(IniName&& other) noexcept
+		: text(std::exchange(other.text, nullptr)),
+		size(std::exchange(other.size, 0)),
+		symbolId(std::exchange(other.symbolId, noSymbol)),
+		resource(std::exchange(other.resource, nullptr))
+	{
+	}
+	IniName& IniName::operator=(const IniName& other)
+	{
+		if (this != &other)
+		{
+			IniName copy{ other };
+			Release();
+			text = std::exchange(copy.text, nullptr);
+			size = std::exchange(copy.size, 0);
+			resource = std::exchange(copy.resource, nullptr);
+		}
+		return *this;
+	}
+	IniName::~IniName()
+	{
+		Release();
+	}
+
+	void IniName::Release()
+	{
+		if (resource)
+			resource->deallocate(const_cast<char*>(text), size + 1, 1);
+		text = nullptr;
+		size = 0;
+		symbolId = noSymbol;
+		resource = nullptr;
+	}
+}
\ No newline at end of file
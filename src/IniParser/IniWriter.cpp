@@ -1,6 +1,339 @@
 #include "../../include/IniParser/IniWriter.h"
 
+#include <cctype>
+#include <sstream>
+
 namespace inip
 {
+	namespace
+	{
+		bool IsIdentifier(std::string_view text)
+		{
+			if (text.empty())
+				return false;
+			if (!std::isalpha(static_cast<unsigned char>(text[0])) && text[0] != '_')
+				return false;
+			for (char c : text)
+			{
+				if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_')
+					return false;
+			}
+			return true;
+		}
+
+		bool IsDigits(std::string_view text)
+		{
+			if (text.empty())
+				return false;
+			for (char c : text)
+			{
+				if (!std::isdigit(static_cast<unsigned char>(c)))
+					return false;
+			}
+			return true;
+		}
+
+		enum class NumberForm
+		{
+			// Written as it is
+			LITERAL,
+			// A whole floating point number, written with a ".0" so it reads back as a FLOAT
+			WHOLE_FLOAT,
+			// Signs, exponents, 'inf' and 'nan', the grammar has none of them
+			QUOTED,
+		};
+
+		NumberForm ClassifyNumber(std::string_view number, bool floatingPoint)
+		{
+			// The scanner reads 'digits' as an INTEGER and 'digits.digits' as a FLOAT
+			std::size_t point = number.find('.');
+			if (point == std::string_view::npos && IsDigits(number))
+				return floatingPoint ? NumberForm::WHOLE_FLOAT : NumberForm::LITERAL;
+			if (point != std::string_view::npos && IsDigits(number.substr(0, point)) && IsDigits(number.substr(point + 1)))
+				return NumberForm::LITERAL;
+			return NumberForm::QUOTED;
+		}
+	}
+
+	// IniWriterError
+
+	IniWriterError::IniWriterError(std::string_view text, std::string_view errMsg)
+		: std::runtime_error("")
+	{
+		CreateErrorMessage(text, errMsg);
+	}
+
+	const char* IniWriterError::what() const noexcept
+	{
+		return errMsg.c_str();
+	}
+
+	void IniWriterError::CreateErrorMessage(std::string_view text, std::string_view errMsg)
+	{
+		std::stringstream sstream;
+		sstream << "IniWriterError error has occurred!\n";
+		sstream << "Text: " << text << "\n";
+		sstream << "Error message: " << errMsg;
+
+		this->errMsg = sstream.str();
+	}
+
+	// IniWriter
+
+	IniWriter::IniWriter(std::ostream& outputStream, std::size_t bufferSize)
+		: outputStream(&outputStream),
+		bufferSize(bufferSize)
+	{
+		buffer.reserve(bufferSize);
+	}
+	IniWriter::IniWriter(const std::filesystem::path& filePath, std::size_t bufferSize)
+		: ownedStream(filePath, std::ios::binary | std::ios::trunc),
+		outputStream(&ownedStream),
+		bufferSize(bufferSize)
+	{
+		if (!ownedStream)
+		{
+			throw std::ofstream::failure{ "I/O runtime error while openning a file!" };
+		}
+		buffer.reserve(bufferSize);
+	}
+	IniWriter::~IniWriter()
+	{
+		try
+		{
+			Flush();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void IniWriter::WriteSettings(const IniSettings& iniSettings)
+	{
+		iniSettings.ForEachGroup([this](const IniGroup& iniGroup)
+		{
+			WriteGroup(iniGroup);
+		});
+	}
+	void IniWriter::WriteGroup(const IniGroup& iniGroup)
+	{
+		BeginGroup(iniGroup.GetGroupName());
+		iniGroup.ForEachOption([this](const IniOption& iniOption)
+		{
+			WriteOption(iniOption);
+		});
+	}
+
+	void IniWriter::BeginGroup(std::string_view groupName)
+	{
+		// Checked up front, so a rejected group leaves nothing half written
+		CheckString(groupName);
+
+		// Groups are separated by an empty line
+		if (groupBegun)
+			Append('\n');
+		groupBegun = true;
+
+		Append('[');
+		AppendName(groupName);
+		Append("]\n");
+	}
+
+	void IniWriter::WriteOption(const IniOption& iniOption)
+	{
+		switch (iniOption.GetOptionType())
+		{
+		case IniOptionType::INTEGER:
+			WriteOption(iniOption.GetKey(), iniOption.GetValue<long long>());
+			break;
+		case IniOptionType::FLOAT:
+			WriteOption(iniOption.GetKey(), iniOption.GetValue<double>());
+			break;
+		case IniOptionType::LIST:
+			WriteListOption(iniOption);
+			break;
+		default:
+			WriteOption(iniOption.GetKey(), iniOption.TryGetValue<std::string_view>().GetValue());
+			break;
+		}
+	}
+	void IniWriter::WriteOption(std::string_view key, std::string_view value)
+	{
+		CheckString(value);
+		BeginOption(key);
+		AppendString(value);
+		Append('\n');
+	}
+	void IniWriter::WriteNumberOption(std::string_view key, std::string_view number, bool floatingPoint)
+	{
+		BeginOption(key);
+		AppendNumber(number, floatingPoint);
+		Append('\n');
+	}
+
+	void IniWriter::WriteListOption(const IniOption& iniOption)
+	{
+		// Elements of a STRING list are checked up front, so a rejected list leaves nothing half written
+		IniResult<IniArrayView<std::string_view>> strings = iniOption.TryGetArray<std::string_view>();
+		if (strings)
+		{
+			for (std::string_view element : strings.GetValue())
+				CheckString(element);
+		}
+
+		BeginOption(iniOption.GetKey());
+
+		auto appendElements = [this](const auto& elements, auto&& appendElement)
+		{
+			for (std::size_t element = 0; element < elements.size(); element++)
+			{
+				if (element != 0)
+					Append(", ");
+				appendElement(elements[element]);
+			}
+		};
+		auto appendNumber = [this](const auto& number)
+		{
+			char buffer[fixedNumberBufferSize];
+			char* end = FormatFixed(buffer, number);
+			AppendNumber(
+				std::string_view{ buffer, static_cast<std::size_t>(end - buffer) },
+				std::is_floating_point_v<std::remove_cv_t<std::remove_reference_t<decltype(number)>>>);
+		};
+
+		// A STRING list's numbers are written quoted, they read back as the same list
+		if (strings)
+		{
+			appendElements(strings.GetValue(), [this](std::string_view element) { AppendString(element); });
+		}
+		else if (IniResult<IniArrayView<long long>> integers = iniOption.TryGetArray<long long>())
+		{
+			appendElements(integers.GetValue(), appendNumber);
+		}
+		else
+		{
+			appendElements(iniOption.GetArray<double>(), appendNumber);
+		}
+		Append('\n');
+	}
+
+	void IniWriter::CheckKey(std::string_view key)
+	{
+		if (!IsIdentifier(key))
+			throw IniWriterError{ key, "An option's key must be an IDENTIFIER!" };
+	}
+	std::string IniWriter::FormatGroupName(std::string_view groupName)
+	{
+		if (IsIdentifier(groupName))
+			return std::string{ groupName };
+		return FormatStringValue(groupName);
+	}
+	std::string IniWriter::FormatStringValue(std::string_view value)
+	{
+		CheckString(value);
+
+		std::string text;
+		text.reserve(value.size() + 2);
+		text += '"';
+		text += value;
+		text += '"';
+		return text;
+	}
+	std::string IniWriter::FormatNumberValue(std::string_view number, bool floatingPoint)
+	{
+		switch (ClassifyNumber(number, floatingPoint))
+		{
+		case NumberForm::WHOLE_FLOAT:
+			return std::string{ number } + ".0";
+		case NumberForm::QUOTED:
+			return FormatStringValue(number);
+		default:
+			return std::string{ number };
+		}
+	}
+
+	void IniWriter::Flush()
+	{
+		WriteBlock(buffer.data(), buffer.size());
+		buffer.clear();
+		if (!outputStream->flush())
+		{
+			throw std::ofstream::failure{ "I/O runtime error while writing a file!" };
+		}
+	}
+
+	void IniWriter::BeginOption(std::string_view key)
+	{
+		if (!groupBegun)
+			throw IniWriterError{ key, "An option must belong to a group, begin one first!" };
+		CheckKey(key);
+
+		Append(key);
+		Append(" = ");
+	}
+
+	void IniWriter::AppendName(std::string_view name)
+	{
+		if (IsIdentifier(name))
+			Append(name);
+		else
+			AppendString(name);
+	}
+	void IniWriter::CheckString(std::string_view value)
+	{
+		if (value.find('"') != std::string_view::npos)
+			throw IniWriterError{ value, "A '\"' can't be written inside of a STRING!" };
+	}
+	void IniWriter::AppendString(std::string_view value)
+	{
+		Append('"');
+		Append(value);
+		Append('"');
+	}
+	void IniWriter::AppendNumber(std::string_view number, bool floatingPoint)
+	{
+		switch (ClassifyNumber(number, floatingPoint))
+		{
+		case NumberForm::LITERAL:
+			Append(number);
+			break;
+		case NumberForm::WHOLE_FLOAT:
+			Append(number);
+			Append(".0");
+			break;
+		case NumberForm::QUOTED:
+			AppendString(number);
+			break;
+		}
+	}
+	void IniWriter::Append(std::string_view text)
+	{
+		if (buffer.size() + text.size() > bufferSize)
+		{
+			WriteBlock(buffer.data(), buffer.size());
+			buffer.clear();
+
+			// Too big to be worth copying
+			if (text.size() >= bufferSize)
+			{
+				WriteBlock(text.data(), text.size());
+				return;
+			}
+		}
+		buffer.append(text);
+	}
+	void IniWriter::Append(char c)
+	{
+		Append(std::string_view{ &c, 1 });
+	}
 
+	void IniWriter::WriteBlock(const char* data, std::size_t size)
+	{
+		if (size == 0)
+			return;
+		if (!outputStream->write(data, static_cast<std::streamsize>(size)))
+		{
+			throw std::ofstream::failure{ "I/O runtime error while writing a file!" };
+		}
+	}
 }
\ No newline at end of file